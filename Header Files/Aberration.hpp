@@ -0,0 +1,33 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <vector>
+
+class Aberration
+{
+public:
+	static const int DEFAULT_COLUMNS = 32; // 32 cells across a 1400x750 screen is 33x18 vertices, which keeps the bending of straight lines under a pixel.
+	static constexpr float MAX_BETA = 0.95; // Past this, nearly everything crowds into a sliver of the screen.
+
+	Aberration(int width, int height, int columns=DEFAULT_COLUMNS);
+	void resize(int width, int height);
+	void setColumns(int columns); // The quality knob. More columns follow the curve more closely, for more triangles; the rows follow the screen's aspect ratio.
+	int getColumns() const;
+	int getRows() const;
+	bool build(float beta); // Moves each grid point to where it appears to an observer moving at beta (along x, as a fraction of c) relative to the scene. Returns false, having done nothing, if neither beta nor the grid has changed since the last build.
+	const std::vector<SDL_Vertex>& vertices() const; // Positioned where they're seen, with texture coordinates where they are.
+	const std::vector<int>& indices() const; // Two triangles per cell.
+	double apparentX(double x, double y) const; // Where a single point of the last build ends up, worked out in double precision, for checking the mesh against.
+private:
+	void layout();
+	void row(float y, float* out) const; // The raw shift of every column in the row at height y, before fitting.
+
+	int width, height, columns, rows;
+	float beta;
+	float fit; // Scales the shifted grid back onto the screen, so nothing is pushed off either edge.
+	bool stale;
+	std::vector<SDL_Vertex> mesh;
+	std::vector<int> triangles;
+	std::vector<float> columnX, shift; // The columns' distances from the centre, and a row's worth of results, padded to a multiple of 8 for the SIMD loop.
+}; // Relativistic aberration. The screen is treated as a pinhole camera with a focal length of the screen's width, looking across the direction of motion. Light from a point at angle theta to the motion is seen at cos(theta') = (cos(theta) + beta)/(1 + beta*cos(theta)), which only moves things along x. The scene is rendered to a texture and drawn through this mesh.
\ No newline at end of file
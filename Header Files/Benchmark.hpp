@@ -0,0 +1,24 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+namespace benchmarks {
+	int run(int argc, char* args[]); // Runs the benchmarks named on the command line after --benchmark, or all of them if none are named. Returns nonzero if any of them failed a consistency check.
+
+	bool aberration(int columns, int builds); // Building the aberration mesh at a given quality, with its vertices checked against the warp worked out in double precision. Also gives how far the middle of a cell is from the curve, which is what more columns buy. Fails if any vertex is off by more than half a pixel.
+	bool aberrationFrames(int surfaceCount, int frames); // Whole 1400x750 frames of surfaceCount scattered platforms, drawn plainly and then warped through the aberration mesh, against the 16.7 ms a frame has at 60 fps. Opens a window, like scaling().
+	bool collision(int surfaceCount, int ticks); // Player-vs-surface collision over a procedurally scattered level, checked with a full loop and with the SpatialGrid.
+	bool dopplerAudio(float beta, int seconds); // The relativistic audio effect over a generated tone, as heard from a frame moving at beta, with its share of a core. Fails if it changes the mix while nothing is shifted, if the tone's pitch is more than 1% off, or if it takes more than 2% of a core.
+	bool fixedPoint(int bodyCount, int ticks); // The float and Q16.16 physics, per body and batched. Fails unless the fixed-point runs agree bit for bit however they're stepped, including after rewinding and replaying. Prints a checksum to compare across builds.
+	bool integrators(int bodyCount, float seconds); // Each integrator at dt = 0.01, 0.1 and 1, timed and compared against the closed-form path.
+	bool jobs(int bodyCount, int ticks); // Integration and broad-phase pairs over a stress level, single-threaded and then split across 1, 2, 4... threads. Fails unless every thread count gives bit-for-bit the same results.
+	bool kinematics(int bodyCount, int ticks); // Body::move() against the batch Kinematics integrator, for a mix of moving platforms and falling projectiles. Also checks that reverseStep() retraces the path, and that leap(), which the game uses, keeps to the exact one a stride at a time.
+	bool lightDelay(int entityCount, int ticks); // LightDelay's per-tick update over entityCount surfaces moving in straight lines, and its retarded positions against the exact ones. Past MAX_TRACKS surfaces, the rest are left untracked. Fails if any is off by more than half a pixel.
+	bool relativityFactors(int ticks, int entityCount); // The Lorentz and doppler factors against high-precision references, the per-tick cost of recomputing them in float against RelativityEngine's memoized ones, and RelativisticKinematics' batched contraction of entityCount surfaces against a double-precision reference. Also checks that the train's proper time, ticked from the camera, keeps to gamma. Fails if any factor is off by more than rounding.
+	bool scaling(int maxEntities, const string& csvPath); // Generated levels of 10, 100, ... up to maxEntities elements, with the time each tick spends rendering, integrating and colliding. Unlike the rest, this opens a window, so that rendering is measured too. Writes the table to csvPath.
+	bool sleeping(int surfaceCount, int ticks); // Moving and bounce-checking a mostly static level with every surface awake, and with the static ones asleep. Fails if sleeping changes the results.
+	bool splitView(int surfaceCount, int frames); // Whole 1400x750 frames with the camera's view alone, and split with the train's beside it at half size, as V does in the game. Opens a window, like scaling().
+	bool timers(int timerCount, int ticks); // Firing timerCount one-shot and periodic timers by checking each one every tick, as main.cpp did with targetTime, and with the TimerWheel. Fails unless both fire the same timers on the same ticks.
+	bool timeJump(int bodyCount, float seconds); // Fast-forwarding bouncing bodies tick by tick against Body::advanceBouncing(), and rewinding them with advanceTo().
+	bool voices(int channels, int seconds); // VoiceManager over a storm of silent sound effects, far more than channels can take, played for real through the audio device. Fails if a critical sound is ever refused, if a sound plays more often at once than its limit, or if the mixer is playing a channel the manager thinks is free.
+} // Timing runs. All but scaling(), aberrationFrames() and splitView() are headless, so their textures are left null.
@@ -5,12 +5,27 @@
 class Body: public Entity
 {
 public:
+	enum Integrator {SEMI_IMPLICIT_EULER, VELOCITY_VERLET, RK4};
+	struct State
+	{
+		float x, y, xPrime, yPrime;
+	};
+	struct FixedState
+	{
+		Fixed x, y;
+		Fixed xStep, yStep; // Velocity times dt, i.e. how far the body moves each tick.
+		Fixed xStepStep, yStepStep; // Acceleration times dt squared, so that a fixed-point step is nothing but additions.
+	};
+
 	Body(Entity e, float x_vel, float y_vel, bool grav=false, bool b=false, float s=1);
 	void move(int reverseArg = 0);
+	void step(float h, Integrator method); // Advances by h simulated seconds with the given integrator. A negative h goes back in time; this exactly undoes a forward step only for the Verlet and RK4 integrators.
 	void jump(int strength);
 	
-	bool isBouncy();
+	bool isBouncy() const;
 	void setBouncy();
+	void sleep(); // Puts the body to sleep if it has no velocity or acceleration, so that move() and Kinematics::move() skip it. Anything that sets its velocity or acceleration wakes it again.
+	bool isAsleep() const;
 	void bounceX(bool velDecay=false);
 	void bounceY(bool velDecay=false);
 	void bounce(bool velDecay=false);
@@ -20,18 +35,48 @@ public:
 	void ifOnEdgeBounce(bool yVelDecay=false); // Bounce reverses all momentum.
 	void ifOnEdgeStop(); // Stop cancels all velocity and acceleration.
 
-	float getXPrime();
-	float getYPrime();
-	float getXPrimePrime();
-	float getYPrimePrime();
+	double getTime() const; // The simulated time the body has reached, in seconds. Starts at 0 and is advanced by move(), step() and advanceTo(). Stands still while the body sleeps.
+	State stateAt(double t) const; // Where the body will be, or was, at time t if nothing touches it in between. O(1), since acceleration is constant.
+	void advanceTo(double t); // Jumps straight to time t, forwards or backwards.
+	double nextEdgeEvent(int* edge) const; // The time at which ifOnEdgeBounce() would next bounce the body, or infinity if it never will. edge is set to 1=right, 2=top, 3=left or 4=bottom.
+	void advanceBouncing(double t, bool yVelDecay=false); // Jumps forwards to time t, bouncing off the edges on the way as ifOnEdgeBounce() would. Costs one step per bounce rather than one per tick.
+
+	float getXPrime() const;
+	float getYPrime() const;
+	float getXPrimePrime() const;
+	float getYPrimePrime() const;
 	void setXPrime(float amount);
 	void setYPrime(float amount);
 	void addVelVector(float direction, float magnitude); // Adds velocity.
 	void addAccelVector(float direction, float magnitude); // Adds acceleration. Direction is in radians, where 0=East. Suitable direction constants are defined in main.cpp.
+
+	static void setTimestep(float timestep, Integrator method);
+	static void setFixedPoint(bool on);
+	static float dt; // The simulated time that move() advances by.
+	static Integrator integrator; // Used by move(). Semi-implicit Euler by default, which is what the levels were tuned with.
+	static bool fixedPoint; // When set, move() works in Q16.16 fixed point instead, so a simulation comes out bit for bit the same whatever it was compiled with. Always semi-implicit Euler.
 private:
+	FixedState fixedState() const; // The fixed-point state to step from. If anything has changed the float state since the last fixed-point step, it's rounded from that instead.
+	void setFixedState(const FixedState& s); // Stores s, and the float state it rounds to, which is what everything else reads.
+	void fixedMove(int reverseArg);
+
 	float xPrime, yPrime; // Velocity is in pixels per tick.
 	float xPrimePrime, yPrimePrime; // Acceleration is in pixels per tick squared.
 	bool affectedByGravity;
 	bool bouncy;
+	struct SleepState
+	{
+		bool asleep = false;
+		SleepState() = default;
+		SleepState(const SleepState& other);
+		SleepState& operator=(const SleepState& other);
+	}; // Copying an awake body into a queue can put it where Kinematics isn't looking, so such copies bump sleepEpoch.
+	SleepState sleepState;
+	static unsigned int sleepEpoch; // Bumped whenever a body wakes or an awake body is copied, so Kinematics knows when its lists of awake bodies might be missing one.
+	void wake();
+	double time;
+	Fixed fixedX, fixedY, fixedXStep, fixedYStep;
 	static constexpr float g = 9.80665; // The real-world value of g is used.
+
+	friend class Kinematics; // So that the batch integrator can copy state in and out without a function call per field.
 }; // Bodies are entities that move according to the principles of kinematics.
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+struct Contact
+{
+	enum Side {NONE, RIGHT, TOP, LEFT, BOTTOM}; // The side of the player that touched, in the numbering collided() and sweptCollision() return.
+	enum Phase {ENTER, STAY, EXIT};
+
+	Contact(char type='n', int index=-1, int side=NONE, float depth=0);
+	bool samePair(const Contact& c) const;
+	bool operator<(const Contact& c) const; // Orders by queue and then index.
+
+	char type; // 'b' for the body render queue and 's' for the surface render queue, as with landedType.
+	int index;
+	Side side;
+	float normalX, normalY; // Points out of whatever was touched, back towards the player.
+	float depth; // How far the player was inside it. 0 for hits the sweep caught before they overlapped.
+	Phase phase;
+}; // One thing the player touched this tick.
+
+class ContactList
+{
+public:
+	void begin(); // Starts a new tick. Last tick's contacts are kept to compare against.
+	void add(const Contact& c); // Records a contact. Only the first one found for each pair is kept, so a pair is only ever handled once a tick.
+	bool has(char type, int index) const; // Whether the pair has already been recorded this tick.
+	const vector<Contact>& finish(); // Ends the tick, and returns this tick's contacts marked ENTER or STAY along with an EXIT for each of last tick's that has gone, in queue and index order.
+	void erase(char type, int index); // Call after taking [index] out of its queue, so the entries after it keep matching their contacts.
+	void clear();
+private:
+	vector<Contact> now, before, events;
+}; // Turns each tick's contacts into enter, stay and exit events, so what the player touches is tested in one pass and handled in one place.
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <atomic>
+#include <vector>
+
+class DopplerAudio
+{
+public:
+	static const int TAPS = 8, PHASES = 64; // The resampler's windowed sinc, with a row of 8 taps for each 64th of a sample, and the rows in between interpolated.
+	static const int HISTORY = 1 << 17; // Frames of the mix kept to read back from: 3 seconds at 44.1 kHz, which is as far behind the game the music is let fall.
+	static const int GRAIN = 4096, FADE = 1024; // How far the read position may drift from where the tempo says it should be before it skips, and how long the skip is crossfaded over.
+	static const int RAMP = 11025; // Frames for the pitch and tempo to go all the way from 1 to 0, so turning relativity on or off slides rather than jumps.
+
+	DopplerAudio();
+	bool attach(); // Registers process() as a post-mix effect. Only 16-bit stereo is handled, so it fails, with a message, for any other format Mix_OpenAudio() gave.
+	void detach();
+	void setTarget(float pitch, float tempo); // Both as fractions of normal speed, at most 1. Safe to call every tick; the audio thread ramps towards whatever was set last.
+	void process(Sint16* samples, int frames); // Runs the effect over interleaved stereo in place. Called from the audio thread once attached.
+	double load() const; // The fraction of the audio's own running time that process() has taken, which is its share of one core.
+	void resetLoad();
+	bool bypassed() const; // True while nothing is shifted and the mix passes straight through.
+private:
+	static void effect(int channel, void* stream, int length, void* self);
+	void write(const Sint16* samples, int frames);
+	void read(double position, float* l, float* r) const; // Interpolates the history at a fractional frame.
+
+	std::vector<float> left, right; // The last HISTORY frames of each channel, with the first TAPS repeated past the end so a read never wraps.
+	std::vector<float> coefficients; // (PHASES + 1) rows of TAPS.
+	long long written; // Frames written so far. Frame n is at n % HISTORY.
+	double readA, readB, tempoPosition; // The two read heads, and where the tempo alone would have got to.
+	float gainA, gainB;
+	int fading; // Frames of crossfade from A to B still to go, or 0.
+	float pitch, tempo; // Where the ramps have got to.
+	std::atomic<float> wet; // Fades between the untouched mix and the resampled one. Atomic since bypassed() reads it from the game thread.
+	std::atomic<float> targetPitch, targetTempo;
+	std::atomic<long long> busyTicks, processedFrames;
+	int rate; // Frames per second, from Mix_QuerySpec().
+	bool attached;
+}; // Relativistic sound. The mix is resampled so it plays at pitch times its frequency, while the read position is kept within a grain of one moving at tempo, skipping with a crossfade when it strays. Seen from a camera, the train's sounds come out doppler shifted and slowed by gamma, and fall behind the game by up to HISTORY frames before catching up.
\ No newline at end of file
@@ -6,30 +6,30 @@ class Entity
 {
 public:
 	Entity(float xCoord, float yCoord, int width, int height, SDL_Texture* tex); 
-	float getX(); 
-	float getY();
+	float getX() const; 
+	float getY() const;
 	void setX(float amount); 
 	void setY(float amount); 
 	void setCoords(float amount1, float amount2);
 	void changeX(float amount); 
 	void changeY(float amount); 
 
-	int getWidth();
-	int getHeight();
+	int getWidth() const;
+	int getHeight() const;
 	void setWidth(int amount);
 	void setHeight(int amount);
 
-	float getSize();
-	double getTilt();
+	float getSize() const;
+	double getTilt() const;
 	void setSize(float s);
 	void setTilt(double degrees);
 	void changeSize(float a);
 	void changeTilt(double b);
 
-	SDL_Texture* getTexture();
+	SDL_Texture* getTexture() const;
 	void setTexture(SDL_Texture* tex);
 	void setTextureDebug(SDL_Texture* tex);
-	SDL_Rect getFrame();
+	SDL_Rect getFrame() const;
 	void setFrameX(float amount);
 	void setFrameY(float amount);
 
@@ -39,16 +39,19 @@ public:
 	void vanish(); // Makes the entity both invisible and intangible.
 	void unvanish(); // Reverses the above.
 	void toggleVanished(); // Switches between the two.
-	bool isVanished();
+	bool isVanished() const;
 
-	std::pair<float,float> centerOf(); // Returns the coordinates of the center of the entity.
+	int getInstanceId() const;
+	void setInstanceId(int id); // Tags the entity with the level element it was created from, so a reloaded level can find it again. 0 means it wasn't created from a level file.
+
+	std::pair<float,float> centerOf() const; // Returns the coordinates of the center of the entity.
 	int entityCollisionDetected(Entity e); // Detects if the entity has collided with another.
-	bool isPlatform();
+	bool isPlatform() const;
 	void makePlatform(); // Corrects the appearance of collidions with the 3D-styled platforms.
-	bool operator==(Entity e); // Defines == on entities according to their source texture.
-	bool operator==(SDL_Texture* t); // Can be used as an alternative to the above.
-	bool operator!=(Entity e); 
-	bool operator!=(SDL_Texture* t); 
+	bool operator==(const Entity& e) const; // Defines == on entities according to their source texture.
+	bool operator==(SDL_Texture* t) const; // Can be used as an alternative to the above.
+	bool operator!=(const Entity& e) const;
+	bool operator!=(SDL_Texture* t) const;
 	
 	virtual void setXPrime(float amount);
 	virtual void setYPrime(float amount); // Does nothing, this is just for compatibility with the subclasses.
@@ -58,6 +61,7 @@ protected:
 	double tilt=0.0; 
 	bool vanished;
 	bool hitboxAdjust;
+	int instanceId = 0;
 	SDL_Rect currentFrame;
 	SDL_Texture* texture;
 	SDL_Texture* sourceTexture;
@@ -0,0 +1,44 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <queue>
+#include <functional>
+
+struct SpacetimeEvent
+{
+	double x, t; // Where and when it happens in the rest frame, in px from the frame's origin and in ticks.
+	double period; // Rest-frame ticks between repeats, or 0 if it only happens once.
+	int kind, target; // What happens and to what, for the caller to act on.
+};
+
+class EventScheduler
+{
+public:
+	struct Due
+	{
+		int event, kind, target;
+		double time; // When it happened in the current frame.
+	};
+	int add(const SpacetimeEvent& e); // Returns the event's number. It's queued at the next setFrame().
+	void clear();
+	void setFrame(double beta, double gamma, double lightSpeed, double now); // Moves every event into a frame moving at beta relative to the rest frame, with t' = gamma*(t - beta*x/c), and queues each one's next occurrence after now. lightSpeed is in px per tick.
+	bool pop(double now, Due* due); // Takes the earliest occurrence due by now, if there is one, and queues that event's next.
+	bool last(int event, double now, double* time) const; // When the event last happened by now in the current frame. Returns false if it hasn't yet.
+	const SpacetimeEvent& event(int event) const;
+	int size() const;
+private:
+	struct Occurrence
+	{
+		double time;
+		int event;
+		long long count; // Which repeat of the event this is.
+		bool operator>(const Occurrence& o) const;
+	};
+	double timeOf(int event, long long count) const;
+	double cycles(int event, double now) const; // How many periods after its first occurrence now is, in the current frame.
+
+	vector<SpacetimeEvent> events;
+	std::priority_queue<Occurrence, vector<Occurrence>, std::greater<Occurrence>> queue; // Only each event's next occurrence is queued, so each tick costs one look at the top, plus O(log n) per event that's due.
+	double beta = 0, gamma = 1, lightSpeed = 1;
+}; // Timed hazards, defined once in the train's frame and seen in whichever frame the player is watching from, so that events that are simultaneous on the train needn't be from a camera.
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+typedef Sint32 Fixed; // Q16.16: whole pixels from -32768 to 32767, in steps of 1/65536.
+
+namespace fixedpoint {
+	const int FRACTION_BITS = 16;
+	const Fixed ONE = 1 << FRACTION_BITS;
+
+	Fixed fromFloat(float f); // Rounds to the nearest step, clamping to the representable range.
+	float toFloat(Fixed f);
+	Fixed multiply(Fixed a, Fixed b); // Rounded to the nearest step.
+	Fixed divide(Fixed a, Fixed b); // Rounded towards zero. b must not be 0.
+} // Conversions and arithmetic for the fixed-point physics mode. Every operation here is exact or rounds the same way on every compiler and CPU.
\ No newline at end of file
@@ -28,18 +28,27 @@ namespace gamefuncs {
 	void removeEntity(vector<Body>* queue, vector<float>* sizeQueue, vector<bool>* hitboxQueue, Entity sprite);
 	void removeEntity(vector<Entity>* queue, vector<float>* sizeQueue, Entity sprite);
 
+	int findInstance(const vector<Surface>* queue, int id);
+	int findInstance(const vector<Body>* queue, int id);
+	int findInstance(const vector<Entity>* queue, int id);
+	void removeInstance(vector<Surface>* queue, vector<float>* sizeQueue, vector<char>* animQueue, int id);
+	void removeInstance(vector<Body>* queue, vector<float>* sizeQueue, vector<bool>* hitboxQueue, int id);
+	void removeInstance(vector<Entity>* queue, vector<float>* sizeQueue, int id);
+
 	void clearEntities(vector<Surface>* queue, vector<float>* sizeQueue, vector<char>* animQueue);
 	void clearEntities(vector<Body>* queue, vector<float>* sizeQueue, vector<bool>* hboxQueue);
 	void clearEntities(vector<Entity>* queue, vector<float>* sizeQueue);
 
 	int collisionDetected(SDL_Rect a, SDL_Rect b);
 	int collided(Entity e, Entity f, float eContraction=1.0, float fContraction=1.0);
+	float sweptCollision(const Entity& e, float dx, float dy, const Entity& f, int* side, float eContraction=1.0, float fContraction=1.0);
+	float penetration(const Entity& e, const Entity& f, int side, float eContraction=1.0, float fContraction=1.0);
 	bool sdlCollided(Entity e, Entity f);
 	bool touching(Entity playerHere, Entity platformHere);
 	bool mouseOver(Entity e, int mX, int mY); 
 
 	float distance(float x1, float x2, float y1, float y2);
-	float entityDistance(Entity e, Entity f);
+	float entityDistance(const Entity& e, const Entity& f);
 
 	void setColour(Entity e, Uint8 r, Uint8 g, Uint8 b);
 	void dopplerEffect(Entity e, Uint8 redshift, Uint8 blueshift);
@@ -48,8 +57,6 @@ namespace gamefuncs {
 	void setTransparency(Entity e, Uint8 a);
 	void resetTransparency(Entity e);
 
-	void playSound(string soundKey, map<string, Mix_Chunk*>& soundMap, int r=0);
-	void stopSound();
 	void startMusic(string musicKey, map<string, Mix_Music*>& musicMap);
 	void toggleMusic();
 	void stopMusic();
@@ -0,0 +1,46 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+
+class JobSystem
+{
+public:
+	typedef std::function<void(int begin, int end, int chunk)> Job;
+
+	JobSystem(int threadCount=0); // 0 starts one thread per core. 1 runs every chunk on the calling thread, which is the single-threaded mode that parallel results are checked against.
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	void parallelFor(int count, int grain, const Job& job); // Runs job over [0,count) in chunks of grain, and returns once every chunk is done. Chunk k is always [k*grain, (k+1)*grain), whatever the thread count, so output written per chunk and merged in chunk order comes out the same every time.
+	static int chunkCount(int count, int grain);
+	int threadCount() const;
+private:
+	struct Chunk
+	{
+		int begin, end, index;
+	};
+	struct Worker
+	{
+		std::mutex lock;
+		std::deque<Chunk> chunks; // The owner takes from the back and thieves from the front, so they only meet on the last chunk.
+	};
+	void work(int self);
+	bool runOne(int self); // Runs a chunk from this thread's own deque, or steals one from another's. Returns false if there were none left anywhere.
+
+	std::vector<std::thread> threads;
+	std::vector<std::unique_ptr<Worker>> workers; // [0] belongs to whichever thread calls parallelFor().
+	const Job* current; // The job the queued chunks belong to.
+	std::atomic<int> remaining;
+	std::mutex wakeLock;
+	std::condition_variable wake;
+	unsigned int batch; // Bumped by each parallelFor(), so sleeping threads can tell new work from a spurious wakeup.
+	bool stopping;
+}; // A small work-stealing thread pool for splitting per-body work over the cores. Only one thread may call parallelFor() at a time.
\ No newline at end of file
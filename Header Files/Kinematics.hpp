@@ -0,0 +1,51 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+class JobSystem;
+
+class Kinematics
+{
+public:
+	void gather(const vector<Body>* queue); // Copies the state of every body in queue into the arrays, replacing what was there. If Body::fixedPoint is set, the fixed-point state is copied too, and step() and reverseStep() work on that until the next gather().
+	void gather(const vector<Surface>* queue);
+	void scatter(vector<Body>* queue) const; // Writes the positions and velocities back. queue must not have changed size since gather().
+	void scatter(vector<Surface>* queue) const;
+	void step(float dt=Body::dt); // Advances every body by dt with semi-implicit Euler, exactly as Body::move() does by default. Fixed-point steps always use the Body::dt that was set at gather().
+	void reverseStep(float dt=Body::dt); // Undoes step(dt), as Body::move(-1) undoes move().
+	void move(vector<Body>* queue, int reverseArg=0); // Moves every body in queue in place, giving the same results as calling move(reverseArg) on each in turn. Sleeping bodies are skipped.
+	void move(vector<Surface>* queue, int reverseArg=0);
+	void leap(vector<Body>* queue, double time, float longest); // Brings every awake body in queue up to time in one velocity Verlet step, which is exact for constant acceleration however long the step. Bouncy bodies bounce off the screen edges when they reach them, not at the end of the step, so nothing is carried through an edge. A body more than longest behind, like one just woken or fired, only catches up by longest. Each body's clock is then set to time.
+	void leap(vector<Surface>* queue, double time, float longest); // The same, with surfaces on paths following them instead.
+	static void leap(Body& body, double time, float longest); // Just the one body, for moving it more often than the rest of its queue.
+	static void leap(Surface& surface, double time, float longest);
+	const vector<int>& awake(const vector<Body>* queue); // The indices of the bodies in queue that may be awake, in ascending order. Only rebuilt after a body wakes or the queue changes, so move() and loops over this list cost nothing for sleeping bodies.
+	const vector<int>& awake(const vector<Surface>* queue);
+	void setJobSystem(JobSystem* jobs); // Lets move() split queues with more than 2*PARALLEL_GRAIN awake bodies across the job system's threads. nullptr goes back to stepping them on the calling thread.
+	int size() const;
+
+	static const int PARALLEL_GRAIN = 4096; // Bodies per job. Smaller queues aren't worth waking the other threads for.
+private:
+	void resize(int count);
+	template <class T> void load(const vector<T>* queue);
+	template <class T> void store(vector<T>* queue) const;
+	struct AwakeList
+	{
+		bool valid = false;
+		const void* data = nullptr;
+		unsigned int size = 0, epoch = 0; // The queue and Body::sleepEpoch as they were when indices was built.
+		vector<int> indices;
+	};
+	template <class T> const vector<int>& awake(const vector<T>* queue, AwakeList& list);
+	template <class T> void advance(vector<T>* queue, int reverseArg, AwakeList& list);
+	template <class T> void leap(vector<T>* queue, double time, float longest, AwakeList& list);
+	template <class T> static void advance(T* b, const int* index, int begin, int end, int reverseArg);
+
+	vector<float> x, y, xPrime, yPrime, xPrimePrime, yPrimePrime; // Structure-of-arrays, so that four or eight bodies fit in one vector register.
+	vector<double> time; // Each body's time when it was gathered.
+	double elapsed = 0; // How far step() and reverseStep() have moved the bodies on since then.
+	JobSystem* jobs = nullptr;
+	bool fixed = false;
+	AwakeList awakeBodies, awakeSurfaces;
+	vector<Fixed> fixedX, fixedY, fixedXStep, fixedYStep, fixedXStepStep, fixedYStepStep;
+}; // Integrates many bodies at once. step() works on its own arrays with SSE/AVX, for simulations that run many ticks between gather() and scatter(); move() steps a render queue in place.
\ No newline at end of file
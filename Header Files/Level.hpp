@@ -0,0 +1,90 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <Windows.h>
+
+struct QueueSet
+{
+	vector<Entity>* queue1;
+	vector<Entity>* queue2;
+	vector<Entity>* queue3;
+	vector<Body>* queue4;
+	vector<Surface>* queue5;
+	vector<float>* sizeQueue2;
+	vector<float>* sizeQueue3;
+	vector<float>* sizeQueue4;
+	vector<float>* sizeQueue5;
+	vector<bool>* hboxQueue;
+	vector<char>* animQueue;
+}; // Organizes the several render queues. queue1=background, queue2=backgroundobject, queue3=object, queue4=body, queue5=surface.
+
+struct LevelElement
+{
+	const Entity* objptr; // The prototype that this element is an instance of. Prototypes are shared between levels and are never modified by loadLevel().
+	char type; // E=Entity, D=Decoration, B=Body, S=Surface.
+	char animCode; // Dictates how (if at all) the object animates once rendered; this is primarily for obstacles. From a design perspective, having them animate brings attention to the fact that they can be interacted with or are potentially harmful. \0 (null char) = no animation, E=electrosphere, B=electro beam, F=initially-on flamethrower, G=initially-off flamethrower, M=missile, C=missile cannon, R=initially-off lightning, L=initially-on lightning,  K=key, H=health refill power-up. \0 returns false when passed as a bool.
+
+	pair<float,float> coordinates; // first=x, second=y.
+	pair<float,float> velocities; // first=x, second=y. Can only be nonzero if the element is a body or surface.
+	float size;
+	bool hitbox = false; // Only for Body instances.
+	vector<pair<float,float>> path; // Waypoints for a moving surface. If there are any, the surface follows them at the speed given by velocities instead of moving freely.
+	bool pathLoops = false; // false means the surface ping-pongs along the waypoints.
+
+	string name; // Unique within its level, so the game can look an element up with findElement().
+	string prototype; // The registry name of objptr, which is what the level files store.
+	int id = 0; // The instance id given to this element's copy in the render queues. Kept across hot reloads for elements with the same name.
+}; // For preparing the objects which need to be put into levels using the Level struct.
+
+struct Level
+{
+	float playerSize;
+	bool floor, ceiling, leftWall, rightWall;
+	bool doorLocked;
+
+	pair<const Entity*,const Entity*> backgrounds;
+	pair<float,float> playerLocation;
+	pair<float,float> doorLocation;
+	pair<float,float> cameraLocation; // If the camera is not in the level, this can simply be set to {-1000,-1000}.
+	pair<float,float> simulCameraLocation; // If the camera is not in the level, this can simply be set to {-1000,-1000}.
+	vector<LevelElement> elements;
+
+	pair<string,string> backgroundNames;
+}; // Contains all the information about a level's objects and initial conditions.
+
+typedef map<string, const Entity*> PrototypeRegistry; // Maps the names used in level files to the prototypes defined in main.cpp.
+
+struct StressSpec
+{
+	int staticSurfaces = 0; // solidPlatform
+	int movingPlatforms = 0; // semisolidPlatform, a quarter of them on paths.
+	int bouncyBodies = 0; // movingBody
+	int hazards = 0; // dmgPlatform
+	int missiles = 0; // missile
+	float width = 1400, height = 750; // The area the elements are scattered over.
+	unsigned int seed = 1;
+}; // How many of each kind of element generateLevel() should scatter, and the prototype each kind is made from.
+
+bool loadLevel(const Level& l, Body& p, QueueSet& q, Entity& door, Entity& cam1, Entity& cam2); // Refuses, leaving the queues alone, a level that failed to load.
+bool levelLoaded(const Level& l); // False for the empty level loadLevels() leaves in place of one that failed to load.
+void fireMissile(QueueSet& q, const Surface& missile, float x, float y, double tilt, float direction);
+const LevelElement* findElement(const Level& l, const string& name);
+bool generateLevel(const StressSpec& spec, const PrototypeRegistry& prototypes, Level& l); // Fills l with randomly placed elements in the numbers spec asks for, for stress testing. The same spec always gives the same level.
+
+bool loadLevelFile(const string& path, const PrototypeRegistry& prototypes, Level& l); // path has no extension; the cooked .lvlc is used if it is at least as new as the .lvl.
+int loadLevels(const string& directory, const PrototypeRegistry& prototypes, vector<Level>& levels); // Appends level1, level2, ... from directory until one is missing. One that can't be parsed is appended empty, so the rest keep their places. Returns the number of levels loaded.
+bool cookLevelFile(const string& path); // Parses path.lvl and writes path.lvlc. Needs no prototypes, so it can run without SDL.
+int cookLevels(const string& directory); // Cooks every levelN file in directory, stopping at the first missing one. Returns the number cooked.
+int patchLevel(const Level& current, Level& edited, QueueSet& q); // Applies the differences between a running level and its edited file to the render queues, without touching the player. Returns the number of elements patched.
+
+class LevelWatcher
+{
+public:
+	LevelWatcher(const string& directory);
+	~LevelWatcher();
+	LevelWatcher(const LevelWatcher&) = delete;
+	LevelWatcher& operator=(const LevelWatcher&) = delete;
+	bool changed(); // Returns true once after any file in the directory is written, created or deleted. Never blocks.
+private:
+	HANDLE notification;
+}; // Watches a level directory for edits so that levels can be reloaded while the game is running.
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+class LightDelay
+{
+public:
+	static const int SAMPLES = 64, STRIDE = 32; // 64 samples 32 ticks apart reach back 2048 ticks, longer than light takes to cross the screen at GAME_SPEED_OF_LIGHT.
+	static const int MAX_TRACKS = 512; // Any more moving entities than this are drawn where they are. 512 tracks of history come to 400 KB.
+
+	LightDelay();
+	void setObserver(float x, float y, float lightSpeed); // Where the light is seen from, and how fast it travels, in px per tick.
+	void update(const vector<Body>* bodies, const vector<Surface>* surfaces, const Body& player, int now); // Records where everything that moves is at tick now, then works out where each one was when the light reaching the observer now left it. Call once per tick, before rendering.
+	void clear(); // Forgets all the history, so everything is drawn where it is until the history builds up again.
+	pair<float,float> bodyOffset(int index) const; // How far from where it is bodyRenderQueue[index] should be drawn. (0,0) for anything that isn't tracked.
+	pair<float,float> surfaceOffset(int index) const;
+	pair<float,float> playerOffset() const;
+	int tracked() const;
+	int memory() const; // In bytes. The history is allocated up front, so this doesn't grow.
+private:
+	struct Track
+	{
+		float x[SAMPLES], y[SAMPLES];
+		int tick[SAMPLES];
+		int newest, count; // A ring, with newest the index of the latest sample.
+		float lastX, lastY; // Where the entity was at the last update(), for telling when something else has been shifted into its queue index.
+		int still; // How many updates it hasn't moved for.
+	};
+	struct Slots
+	{
+		vector<int> track; // Into tracks, per queue index, or -1.
+		vector<pair<float,float>> offset;
+	};
+	template <class T> void follow(const T& e, int index, Slots& slots, int now);
+	void record(Track& t, float x, float y, int now);
+	pair<float,float> solve(const Track& t, float x, float y, int now) const; // Binary searches the samples for the one the light cone crosses after, then interpolates.
+	void release(Slots& slots, int index);
+	void trim(Slots& slots, int count);
+
+	vector<Track> tracks;
+	vector<int> freeTracks;
+	Slots bodySlots, surfaceSlots, playerSlots;
+	float observerX = 0, observerY = 0, lightSpeed = 1;
+	int lastTick = 0;
+}; // Retarded positions. Light at GAME_SPEED_OF_LIGHT takes a couple of thousand ticks to cross the screen, so with this on, moving things are drawn where they were when the light now reaching the observer left them. Only entities that move get a history, so static levels cost one check per entity.
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+class Path
+{
+public:
+	Path();
+	Path(std::pair<float,float> start, float speed, const std::vector<std::pair<float,float>>& waypoints, bool loops);
+	bool isEmpty() const;
+	std::pair<float,float> positionAt(double t) const; // Where the platform is t simulated seconds after leaving start. Before 0, it is further back along the line to the first waypoint.
+	std::pair<float,float> velocityAt(double t) const;
+private:
+	int segmentAt(double t, double* along) const; // The index of the segment the platform is on at time t, and how far along it, in pixels.
+
+	std::vector<std::pair<float,float>> points; // start, then the waypoints, then for ping-pong paths the waypoints again in reverse, and for loops the first waypoint again.
+	std::vector<double> distances; // How far along the path each point is.
+	float speed;
+	double leadIn, cycle; // The length of the segment from start to the first waypoint, and of one trip round the rest of the path.
+}; // A route for a moving platform. The platform heads from its starting point to the first waypoint, then either ping-pongs along the waypoints or loops round them, at a constant speed. Positions are worked out in closed form, so a platform can never overshoot an end however large the timestep.
\ No newline at end of file
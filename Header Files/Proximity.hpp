@@ -0,0 +1,29 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+class ProximityIndex
+{
+public:
+	int add(const Entity* e, float radius); // Adds a zone of the given radius around e's centre, and returns its number.
+	int add(const vector<Entity>* queue, int index, float radius); // Adds a zone around queue entry [index]. The entry is looked up at each update, so the zone survives the queue being refilled. A negative index means the zone is empty for now.
+	void setIndex(int zone, int index); // Points a queue zone at another entry, for things whose place in the queue changes from level to level.
+	void update(const Entity& player); // Measures the player against every zone. Call once per tick; everything else just reads the results.
+	bool inRange(int zone) const;
+	bool entered(int zone) const; // Whether the player came into range at the last update.
+	bool left(int zone) const; // Whether the player went out of range at the last update.
+	float distance(int zone) const; // Between centres, as entityDistance() measures it.
+	void reset(); // Counts the player as out of range everywhere, so each zone they're in reports entered() again at the next update. For a new level, or when what a zone does has changed, like the door being unlocked.
+private:
+	struct Zone
+	{
+		const Entity* entity;
+		const vector<Entity>* queue;
+		int index;
+		float radius, distance;
+		bool inside, wasInside;
+	};
+	const Entity* target(const Zone& z) const;
+
+	vector<Zone> zones;
+}; // Answers which interactables the player is near once per tick, rather than each of them measuring the distance again wherever it's needed.
\ No newline at end of file
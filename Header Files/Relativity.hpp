@@ -0,0 +1,76 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+const double SPEED_OF_LIGHT = 299792458.0; // in m/s.
+const float GAME_SPEED_OF_LIGHT = 72; // in px per unit of simulated time, for velocities on the train. Chosen so that the player at full speed, seen from the first camera, is contracted about as much as the old per-entity formula had them.
+
+struct FrameOfReference
+{
+	bool playerInFrame;
+	double velocity; // With respect to Earth.
+	double properTime = 0; // In ticks, as kept by RelativityEngine::advance().
+}; // It's an inertial frame of reference, of course.
+
+namespace relativity {
+	double beta(const FrameOfReference& s, const FrameOfReference& sPrime); // The velocity of the relative motion between the two frames, as a fraction of c.
+	double addVelocities(double beta1, double beta2); // Relativistic velocity addition, as fractions of c: the velocity of something moving at beta2 in a frame that itself moves at beta1.
+	double rapidity(double beta); // Rapidities add where velocities don't, so they're the easy way to combine boosts.
+	double lorentzFactor(double beta);
+	double dopplerFactor(double beta); // The factor governing the relativistic doppler effect, i.e. by which light frequencies are multiplied.
+	std::pair<Uint8,Uint8> dopplerShift(double dFactor);
+}
+
+class RelativityEngine
+{
+public:
+	struct Factors
+	{
+		double beta, rapidity, gamma, doppler;
+		Uint8 redshift, blueshift; // The magnitudes of the relativistic doppler effect, for dopplerEffect().
+	};
+	const Factors& between(const FrameOfReference& s, const FrameOfReference& sPrime); // Looks the pair of frames up, and only works their factors out again if their velocities have changed since it was last asked. The reference lasts until the next call.
+	int advance(FrameOfReference& frame, const FrameOfReference& watching, double ticks=1); // Moves frame's clock on by ticks of the watching frame's time, divided by gamma between them. Returns how many whole ticks of proper time that passed, which for gamma >= 1 is never more than ticks rounded up.
+	int recomputations() const; // How many times the factors have actually been worked out.
+private:
+	struct Entry
+	{
+		const FrameOfReference* s;
+		const FrameOfReference* sPrime;
+		double sVelocity, sPrimeVelocity;
+		Factors factors;
+	};
+	vector<Entry> entries; // One per pair of frames asked about. The game only ever has two.
+	int computed = 0;
+}; // The velocities only change between levels, in steps of 0.005c, so each tick just reads back what the last one worked out.
+
+class RelativisticKinematics
+{
+public:
+	void setFrame(const RelativityEngine::Factors& frame); // The factors between the train and the frame the player is watching from.
+	void clearFrame(); // Watching from the train, where the game shows nothing contracted.
+	void update(const vector<Body>* bodies, const vector<Surface>* surfaces); // Works out every entity's factors for this tick. Call once, before rendering.
+	void refresh(const vector<Body>* bodies, const vector<Surface>* surfaces); // Calls update() again only if a queue has been resized since, for after entities are added or removed mid-tick.
+	float bodyContraction(int index) const; // By how much bodyRenderQueue[index] is contracted in x. Entries added since the last update aren't contracted.
+	float surfaceContraction(int index) const;
+	float bodyDilation(int index) const; // How much slower bodyRenderQueue[index]'s clock runs than one at rest on the train.
+	float surfaceDilation(int index) const;
+	float contraction(const Body& b) const; // For a single entity, like the player, worked out on the spot.
+	float dilation(const Body& b) const;
+
+	static constexpr float MIN_CONTRACTION = 0.5; // Prevents too much warping due to length contraction.
+	static constexpr float MAX_BETA = 0.999; // Anything faster than light on the train is treated as just under it.
+private:
+	struct Cache
+	{
+		vector<float> velocity, contraction, dilation;
+		const void* data = nullptr;
+		unsigned int size = 0; // The queue as it was at the last update.
+	};
+	template <class T> void update(const vector<T>* queue, Cache& cache);
+	void factors(const float* velocity, float* contraction, float* dilation, int count) const;
+
+	bool on = false;
+	float beta = 0; // The train's velocity relative to the watching frame.
+	Cache bodies, surfaces;
+}; // Each entity's velocity in the watching frame is its velocity on the train added relativistically to the train's own, which gives its contraction and time dilation. Things at rest on the train are drawn at their normal size, so the factors are relative to those: anything moving with the train gets shorter, and anything moving against it, longer.
\ No newline at end of file
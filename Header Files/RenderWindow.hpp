@@ -3,6 +3,7 @@
 #include <SDL2/SDL_image.h>
 
 #include "Entity.hpp"
+#include "Aberration.hpp"
 
 class RenderWindow
 {
@@ -12,7 +13,12 @@ public:
 	void cleanUp(); // Deletes everything to prevent memory leaks.
 	void clear(); // Clears the screen before rendering new images.
 	void render(Entity& e, float scaleFactor=1.0, float contractionFactorH=1.0, float contractionFactorV=1.0, bool flipH=false, bool flipV=false, double angle=0.0, int centerOffsetX=0, int centerOffsetY=0); // Renders an image.
-	void renderFullscreen(Entity& e); // Renders an image in fullscreen.
+	void renderFullscreen(Entity& e); // Renders an image in fullscreen, or over the whole viewport if one is set.
+	void setOffset(std::pair<float,float> offset); // Shifts where render() draws everything by offset, until it's set back to {0, 0}.
+	void beginAberration(float beta); // Sends everything rendered from here on to an offscreen texture, to be drawn warped for an observer moving at beta relative to the scene. Does nothing for beta = 0.
+	void endAberration(); // Draws the offscreen texture to the screen through the aberration mesh. display() does this itself if it hasn't been done.
+	void setAberrationQuality(int columns); // How many cells across the aberration mesh has. See Aberration::setColumns().
+	void setViewport(const SDL_Rect* area); // Squeezes the scene between beginAberration() and endAberration() into area of the screen, for drawing more than one view at once. nullptr goes back to the whole window.
 	void setFullscreen();
 	void exitFullscreen();
 	void display(); // Displays a rendered image.
@@ -21,4 +27,13 @@ public:
 private:
 	SDL_Window* window;
 	SDL_Renderer* renderer;
+	std::pair<float,float> offset;
+	int width, height;
+	Aberration aberration;
+	SDL_Texture* warpTarget; // Created the first time it's needed, at the window's size.
+	bool warping, warpFailed; // warpFailed turns the effect off for good after the renderer turns down a target or the geometry.
+	bool squeezing; // Drawing into the viewport through the renderer's viewport and scale, since there's no target to warp.
+	SDL_Rect viewport;
+	bool viewportSet;
+	std::vector<SDL_Vertex> placed; // The aberration mesh moved into the viewport.
 }; // The window that the game is displayed from.
\ No newline at end of file
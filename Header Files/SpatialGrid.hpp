@@ -0,0 +1,46 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <unordered_map>
+
+class JobSystem;
+
+class SpatialGrid
+{
+public:
+	SpatialGrid(int cellSize=128);
+	void sync(int index, SDL_Rect r, bool collidable=true); // Puts render queue entry [index] in the cells under r. Only touches the cells if they've changed since the last sync.
+	void sync(const vector<Surface>* queue); // Syncs every surface. Vanished surfaces, and those that neither block nor hurt the player and aren't triggers, are never returned by query().
+	void sync(const vector<Body>* queue, const vector<bool>* hitboxQueue); // Syncs every body. Vanished bodies and those without a hitbox are never returned by query().
+	void trim(int count); // Drops the entries at [count] and beyond, for when the queue has shrunk.
+	void clear();
+	const vector<int>& query(SDL_Rect r); // Returns the indices of the entries that might overlap r, in ascending order, so callers test them in the same order as a full loop over the queue would.
+	void pairs(const vector<SDL_Rect>& rects, vector<pair<int,int>>* out, JobSystem* jobs=nullptr) const; // Broad phase for many movers at once. Fills out with every (rect index, entry index) that might overlap, ordered by rect and then by entry. Large batches are split across the job system's threads, with the same output either way. The game only ever has the player to collide, which query() covers; this is for the stress levels, where thousands of bodies move at once, and is what --benchmark jobs measures.
+	int size() const;
+private:
+	struct Cells
+	{
+		int x1, y1, x2, y2; // Inclusive cell coordinates. x1 > x2 means the entry isn't in the grid.
+	};
+	struct Entry
+	{
+		Cells cells;
+		bool collidable;
+		float x, y, size; // What the entry looked like at its last full sync; if these haven't changed, nothing else needs checking.
+	};
+	Cells cellsUnder(SDL_Rect r) const;
+	void insert(int index, Cells c);
+	void erase(int index, Cells c);
+	bool unchanged(int index, const Entity& e);
+	void candidates(SDL_Rect r, vector<int>* found) const; // query() without the shared result buffer, so several threads can run it at once.
+
+	static const int PAIR_GRAIN = 256; // Rects per job in pairs().
+
+	int cellSize;
+	vector<Entry> entries;
+	std::unordered_map<long long, vector<int>> cells; // Keyed by packed cell coordinates, so the grid has no fixed bounds and empty space costs nothing.
+	vector<int> results;
+	vector<unsigned int> lastQuery; // For each entry, the query it was last returned by; stops entries spanning several cells being returned twice.
+	unsigned int queryCount;
+}; // A uniform grid over the render queues, so that collision only has to look at entries near the player.
\ No newline at end of file
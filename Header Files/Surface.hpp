@@ -6,10 +6,19 @@ class Surface: public Body
 {
 public:
 	Surface(Entity e, bool rSolid, bool tSolid, bool lSolid, bool bSolid, int dmg=0, float s=1, bool h=false);
-	bool isSolid(int i);
-	int getDamage();
+	bool isSolid(int i) const;
+	int getDamage() const;
 	void setDamage(int d);
+	void setTrigger(); // Triggers block nothing and do no damage, but the player still gets contacts for touching them, like pickups.
+	bool isTrigger() const;
+
+	void setPath(const Path& p); // Puts the surface at the start of p, which it then follows instead of moving by its velocity.
+	bool followsPath() const;
+	void followPath(float dt); // Advances along the path by dt simulated seconds, setting both position and velocity.
 private:
 	bool solid[5];
 	int damage; 
+	bool trigger;
+	Path path;
+	double pathTime; // How long the surface has been following its path. Positions are worked out from this rather than accumulated, so they never drift.
 }; // Surfaces are entities that the player can collide with and/or take damage from.
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+struct TimerId
+{
+	int node = -1;
+	unsigned int generation = 0;
+}; // Refers to a timer until it's cancelled, or, for a one-shot, until it has fired and been popped. A default TimerId refers to nothing.
+
+class TimerWheel
+{
+public:
+	struct Fired
+	{
+		int kind, target;
+		TimerId id;
+	};
+	TimerWheel();
+	TimerId start(int kind, int delay, int period=0, int target=0); // Fires kind after delay ticks (at least 1), then every period ticks after that if period is above 0. target is handed back with it for the caller's use.
+	void cancel(TimerId& id); // Also drops it if it has fired but not been popped yet. Cancelling a timer that's already gone does nothing.
+	bool pending(TimerId id) const; // True until a one-shot has fired and been popped, and until a periodic timer is cancelled.
+	void advance(); // Moves on a tick, readying every timer that falls due on it.
+	bool pop(Fired* fired); // Takes the earliest readied timer, if there is one. Timers stay ready until popped, so none are lost on ticks where nothing checks for them.
+	void clear(); // Cancels everything, without invalidating the clock.
+	int now() const;
+	int size() const; // How many timers are running.
+	static int until(int now, int period, int phase); // The ticks from now until the next tick t with t%period == phase, for lining a periodic timer up with the level timer.
+private:
+	static const int LEVELS = 4, SLOT_BITS = 6, SLOTS = 1 << SLOT_BITS, MASK = SLOTS - 1;
+	static const int FREE = -2, READY = -1; // Node::list values for nodes not in a slot.
+	struct Node
+	{
+		int expires, period, kind, target;
+		int prev, next, list; // list is the slot the node is in.
+		unsigned int generation;
+	};
+	void insert(int node);
+	void unlink(int node);
+	void cascade(int level);
+	void release(int node);
+
+	vector<Node> nodes;
+	int heads[LEVELS*SLOTS];
+	int freeList;
+	vector<TimerId> ready;
+	unsigned int readFrom;
+	int ticks, count;
+}; // A hierarchical timing wheel. Level 0 has a slot for each of the next 64 ticks, and each level above covers 64 times the span of the one below, so starting, cancelling and firing a timer cost the same however many others are running. Timers further out than 64^4 ticks are parked in the top level and looked at again each time it comes round.
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+class VoiceManager
+{
+public:
+	enum Priority {AMBIENT, HAZARD, ACTION, CUE, CRITICAL}; // A sound only takes a channel from one of lower priority.
+	struct Stats
+	{
+		int played = 0;
+		int stolen = 0; // Voices cut off to make room for more important ones.
+		int dropped = 0; // Sounds not played because every channel held something at least as important.
+		int limited = 0; // Not played because as many of the same sound were already playing as it's allowed.
+		int cooling = 0; // Not played because the same sound had started too recently.
+		int peak = 0; // The most channels in use at once.
+	};
+	static const int CHANNELS = 16;
+	static const int QUEUE = 256; // Finished channels waiting to be picked up. More than CHANNELS can finish between two update()s only if they're restarted and finish again, and then the extras are simply stale.
+
+	VoiceManager(int channels=CHANNELS); // Call after Mix_OpenAudio(). Only one may exist at a time, since Mix_ChannelFinished() has nowhere to say which.
+	~VoiceManager();
+	VoiceManager(const VoiceManager&) = delete;
+	VoiceManager& operator=(const VoiceManager&) = delete;
+	void define(const std::string& key, Mix_Chunk* chunk, Priority priority, int maxInstances=2, Uint32 cooldown=0); // cooldown is in ms. Sounds that aren't defined can't be played.
+	int play(const std::string& key, int loops=0); // Returns the channel, or -1 if it was refused.
+	void stopAll();
+	void update(); // Frees the channels the audio thread has said are finished. Call once per tick.
+	void detach(); // Stops SDL_mixer calling back into this. Call before Mix_Quit(), since the destructor may run after it.
+	int inUse() const;
+	int channels() const;
+	const Stats& stats() const;
+	void report() const; // Prints the channel usage and what was dropped, and why.
+private:
+	struct Sound
+	{
+		std::string key;
+		Mix_Chunk* chunk;
+		Priority priority;
+		int maxInstances, playing;
+		Uint32 cooldown, lastStart;
+		bool started; // lastStart means nothing until it has been.
+	};
+	struct Voice
+	{
+		int sound; // Into sounds, or -1 for a free channel.
+		Uint32 start;
+	};
+	static void finished(int channel); // Called by SDL_mixer on the audio thread, or on this one when a channel is halted.
+	int freeChannel() const; // -1 if every channel is busy.
+	void release(int channel);
+
+	std::vector<Sound> sounds;
+	std::map<std::string,int> keys;
+	std::vector<Voice> voices;
+	int busy;
+	Stats counts;
+
+	int done[QUEUE]; // A single-producer, single-consumer ring: the audio thread pushes finished channels, and update() pops them.
+	std::atomic<unsigned int> head, tail;
+	std::atomic<int> halting; // A channel this thread is halting itself, whose finished() is ignored, or -2 for none. -1 is all of them.
+	static VoiceManager* current;
+}; // Decides which sound effects get a channel. Each sound has a priority, a cap on how many of it play at once, and a cooldown between starts. When the channels run out, the least important voice playing (the oldest, among equals) is cut off, but only for something more important. The game thread starts and stops every channel itself; the audio thread only reports back, through a lock-free queue, when one has finished.
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+#include "Aberration.hpp"
+
+Aberration::Aberration(int width, int height, int columns)
+: width(width), height(height), columns(std::max(columns, 1)), rows(1), beta(0), fit(1), stale(true)
+{
+	layout();
+}
+
+void Aberration::resize(int width, int height)
+{
+	if (width == this->width && height == this->height)
+		return;
+	this->width = width;
+	this->height = height;
+	layout();
+}
+
+void Aberration::setColumns(int columns)
+{
+	columns = std::max(columns, 1);
+	if (columns == this->columns)
+		return;
+	this->columns = columns;
+	layout();
+}
+
+int Aberration::getColumns() const
+{
+	return columns;
+}
+
+int Aberration::getRows() const
+{
+	return rows;
+}
+
+void Aberration::layout()
+{
+	rows = std::max(1, static_cast<int>(std::lround(static_cast<double>(columns) * height / width)));
+	int across = columns + 1;
+
+	columnX.assign((across + 7) & ~7, 0);
+	shift.assign(columnX.size(), 0);
+	for (int i = 0; i < across; i++)
+		columnX[i] = static_cast<float>(width) * i / columns - width/2.0f;
+
+	mesh.resize(across * (rows + 1));
+	for (int j = 0; j <= rows; j++) {
+		for (int i = 0; i < across; i++) {
+			SDL_Vertex& v = mesh[j*across + i];
+			v.position = {static_cast<float>(width) * i / columns, static_cast<float>(height) * j / rows};
+			v.color = {0xFF, 0xFF, 0xFF, 0xFF};
+			v.tex_coord = {static_cast<float>(i) / columns, static_cast<float>(j) / rows};
+		}
+	}
+
+	triangles.clear();
+	for (int j = 0; j < rows; j++) {
+		for (int i = 0; i < columns; i++) {
+			int k = j*across + i;
+			triangles.insert(triangles.end(), {k, k + 1, k + across, k + 1, k + across + 1, k + across});
+		}
+	}
+	stale = true;
+} // Only the x of each vertex changes from build to build, so everything else is set up here.
+
+void Aberration::row(float y, float* out) const
+{
+	float r2 = y*y + static_cast<float>(width)*width, r = std::sqrt(r2); // The distance from the pinhole to the point on the row's centre line.
+	float b = beta, bg = beta/std::sqrt((1 - beta)*(1 + beta)); // cot(theta') for the centre of the screen, which stays put.
+	int count = columnX.size(), i = 0;
+#if defined(__AVX__)
+	__m256 vr2 = _mm256_set1_ps(r2), vr = _mm256_set1_ps(r), vb = _mm256_set1_ps(b), vbg = _mm256_set1_ps(bg), one = _mm256_set1_ps(1), least = _mm256_set1_ps(1e-6f);
+	for (; i + 8 <= count; i += 8) {
+		__m256 x = _mm256_loadu_ps(&columnX[i]);
+		__m256 cosine = _mm256_div_ps(x, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), vr2)));
+		__m256 seen = _mm256_div_ps(_mm256_add_ps(cosine, vb), _mm256_add_ps(one, _mm256_mul_ps(vb, cosine)));
+		__m256 sine = _mm256_sqrt_ps(_mm256_max_ps(least, _mm256_sub_ps(one, _mm256_mul_ps(seen, seen))));
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(vr, _mm256_sub_ps(_mm256_div_ps(seen, sine), vbg)));
+	}
+#else
+	__m128 vr2 = _mm_set1_ps(r2), vr = _mm_set1_ps(r), vb = _mm_set1_ps(b), vbg = _mm_set1_ps(bg), one = _mm_set1_ps(1), least = _mm_set1_ps(1e-6f);
+	for (; i + 4 <= count; i += 4) {
+		__m128 x = _mm_loadu_ps(&columnX[i]);
+		__m128 cosine = _mm_div_ps(x, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), vr2)));
+		__m128 seen = _mm_div_ps(_mm_add_ps(cosine, vb), _mm_add_ps(one, _mm_mul_ps(vb, cosine)));
+		__m128 sine = _mm_sqrt_ps(_mm_max_ps(least, _mm_sub_ps(one, _mm_mul_ps(seen, seen))));
+		_mm_storeu_ps(out + i, _mm_mul_ps(vr, _mm_sub_ps(_mm_div_ps(seen, sine), vbg)));
+	}
+#endif
+	for (; i < count; i++) {
+		float cosine = columnX[i]/std::sqrt(columnX[i]*columnX[i] + r2);
+		float seen = (cosine + b)/(1 + b*cosine);
+		out[i] = r*(seen/std::sqrt(std::max(1e-6f, 1 - seen*seen)) - bg);
+	}
+} // Projected back through the pinhole, a point's distance from the centre column is r*cot(theta'). Taking off the centre's own cot keeps the middle of the screen where it was.
+
+bool Aberration::build(float beta)
+{
+	beta = std::max(-MAX_BETA, std::min(MAX_BETA, beta));
+	if (beta == this->beta && !stale)
+		return false;
+	this->beta = beta;
+	stale = false;
+
+	int across = columns + 1;
+	float reach = width/2.0f;
+	for (int j = 0; j <= rows; j++) {
+		row(height * (static_cast<float>(j) / rows - 0.5f), shift.data());
+		reach = std::max(reach, std::max(-shift[0], shift[columns]));
+		for (int i = 0; i < across; i++)
+			mesh[j*across + i].position.x = shift[i];
+	}
+
+	fit = width/2.0f / reach;
+	for (SDL_Vertex& v : mesh)
+		v.position.x = v.position.x*fit + width/2.0f;
+	return true;
+} // Ahead of the observer, things spread out, and behind, they bunch up, so the whole grid is shrunk until the side that's pushed out fits. The other side is left short of its edge, and whatever's behind the scene shows through.
+
+const std::vector<SDL_Vertex>& Aberration::vertices() const
+{
+	return mesh;
+}
+
+const std::vector<int>& Aberration::indices() const
+{
+	return triangles;
+}
+
+double Aberration::apparentX(double x, double y) const
+{
+	double dx = x - width/2.0, dy = y - height/2.0;
+	double r = std::sqrt(dy*dy + static_cast<double>(width)*width);
+	double cosine = dx/std::sqrt(dx*dx + r*r), b = beta;
+	double seen = (cosine + b)/(1 + b*cosine);
+	return r*(seen/std::sqrt(1 - seen*seen) - b/std::sqrt((1 - b)*(1 + b)))*fit + width/2.0;
+}
\ No newline at end of file
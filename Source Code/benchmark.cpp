@@ -0,0 +1,1243 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <cfloat>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+#include <Windows.h>
+
+#include "RenderWindow.hpp"
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "Level.hpp"
+#include "JobSystem.hpp"
+#include "SpatialGrid.hpp"
+#include "Kinematics.hpp"
+#include "Relativity.hpp"
+#include "TimerWheel.hpp"
+#include "LightDelay.hpp"
+#include "Aberration.hpp"
+#include "DopplerAudio.hpp"
+#include "VoiceManager.hpp"
+#include "Benchmark.hpp"
+
+using std::string;
+using std::vector;
+using namespace gamefuncs;
+
+static double secondsSince(Uint64 start)
+{
+	return double(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+static vector<Surface> scatterSurfaces(int count, float worldWidth, float worldHeight)
+{
+	vector<Surface> surfaces;
+	surfaces.reserve(count);
+	std::srand(12);
+
+	for (int i = 0; i < count; i++) {
+		int kind = std::rand() % 10;
+		Entity sprite(std::rand() % int(worldWidth), std::rand() % int(worldHeight), kind < 6 ? 341 : 100, kind < 6 ? 48 : 100, nullptr);
+		Surface s(sprite, kind < 8, kind < 8, kind < 8, true, kind == 9 ? 1 : 0, 0.5 + (std::rand() % 100) / 100.0);
+		if (kind < 6)
+			s.makePlatform();
+		if (kind == 0)
+			s.setXPrime((std::rand() % 21) - 10);
+		if (kind == 1)
+			s.setYPrime((std::rand() % 21) - 10);
+		if (kind == 7 && std::rand() % 4 == 0)
+			s.vanish();
+		surfaces.push_back(s);
+	}
+	return surfaces;
+} // A mix of static and moving platforms, blocks, hazards and collected (vanished) pickups, at roughly the density of the hand-made levels.
+
+bool benchmarks::collision(int surfaceCount, int ticks)
+{
+	float worldWidth = 1400, worldHeight = 750;
+	while (worldWidth * worldHeight < surfaceCount * 35000.0f) {
+		worldWidth *= 2;
+		worldHeight *= 1.5;
+	} // The hand-made levels have about 30 surfaces per 1400x750 screen.
+
+	vector<Surface> bruteQueue = scatterSurfaces(surfaceCount, worldWidth, worldHeight);
+	vector<Surface> gridQueue = bruteQueue;
+	Body player(Entity(0, 0, 198, 336, nullptr), 0, 0, false, false, 0.4);
+	SpatialGrid grid;
+
+	long long bruteHits = 0, gridHits = 0, candidates = 0;
+	double bruteTime = 0, gridTime = 0;
+
+	for (int t = 0; t < ticks; t++) {
+		player.setCoords(std::fmod(t * 7.0f, worldWidth), worldHeight/2 + std::sin(t * 0.01f) * worldHeight/3); // Sweeps across the whole level.
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		for (unsigned int i = 0; i < bruteQueue.size(); i++) {
+			bruteQueue[i].move();
+			if (bruteQueue[i].isVanished())
+				continue;
+			bool hurt = bruteQueue[i].getDamage() > 0 && sdlCollided(player, bruteQueue[i]);
+			int side = collided(player, bruteQueue[i]);
+			if (hurt || (side && bruteQueue[i].isSolid(side)))
+				bruteHits++;
+		}
+		bruteTime += secondsSince(start);
+
+		start = SDL_GetPerformanceCounter();
+		for (unsigned int i = 0; i < gridQueue.size(); i++)
+			gridQueue[i].move();
+		grid.sync(&gridQueue);
+		SDL_Rect reach = {static_cast<int>(player.getX()) - 32, static_cast<int>(player.getY()) - 32, static_cast<int>(player.getWidth()*player.getSize()) + 64, static_cast<int>(player.getHeight()*player.getSize()) + 64};
+		for (int i : grid.query(reach)) {
+			bool hurt = gridQueue[i].getDamage() > 0 && sdlCollided(player, gridQueue[i]);
+			int side = collided(player, gridQueue[i]);
+			if (hurt || (side && gridQueue[i].isSolid(side)))
+				gridHits++;
+			candidates++;
+		}
+		gridTime += secondsSince(start);
+	} // Both loops move every surface, as the game does each tick, so the difference is purely the collision tests.
+
+	std::cout << "collision: " << surfaceCount << " surfaces, " << ticks << " ticks\n";
+	std::cout << "  full loop:    " << bruteTime / ticks * 1e6 << " us/tick, " << bruteHits << " hits\n";
+	std::cout << "  spatial grid: " << gridTime / ticks * 1e6 << " us/tick, " << gridHits << " hits, " << double(candidates) / ticks << " candidates/tick\n";
+
+	if (bruteHits != gridHits) {
+		std::cout << "  Error: the grid missed " << bruteHits - gridHits << " hits.\n";
+		return false;
+	}
+	return true;
+}
+
+static vector<Body> launchBodies(int count)
+{
+	vector<Body> bodies;
+	bodies.reserve(count);
+	std::srand(31);
+
+	for (int i = 0; i < count; i++) {
+		Body b(Entity(std::rand() % 1400, std::rand() % 750, 48, 48, nullptr), (std::rand() % 41) - 20, (std::rand() % 41) - 20);
+		if (i % 2)
+			b.jump(std::rand() % 30); // Projectiles fall under gravity; the rest move at constant velocity like platforms.
+		bodies.push_back(b);
+	}
+	return bodies;
+}
+
+static float maxDifference(const vector<Body>& a, const vector<Body>& b)
+{
+	float worst = 0;
+	for (unsigned int i = 0; i < a.size(); i++) {
+		worst = std::max(worst, std::abs(a[i].getX() - b[i].getX()));
+		worst = std::max(worst, std::abs(a[i].getY() - b[i].getY()));
+		worst = std::max(worst, std::abs(a[i].getXPrime() - b[i].getXPrime()));
+		worst = std::max(worst, std::abs(a[i].getYPrime() - b[i].getYPrime()));
+	}
+	return worst;
+}
+
+template <class T>
+static bool identical(const vector<T>& a, const vector<T>& b)
+{
+	for (unsigned int i = 0; i < a.size(); i++) {
+		if (a[i].getX() != b[i].getX() || a[i].getY() != b[i].getY() || a[i].getXPrime() != b[i].getXPrime() || a[i].getYPrime() != b[i].getYPrime())
+			return false;
+	}
+	return a.size() == b.size();
+}
+
+bool benchmarks::kinematics(int bodyCount, int ticks)
+{
+	vector<Body> start = launchBodies(bodyCount);
+	vector<Body> scalarQueue = start, batchQueue = start, inPlaceQueue = start, gatherQueue = start;
+	Kinematics batch;
+
+	Uint64 begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++) {
+		for (unsigned int i = 0; i < scalarQueue.size(); i++)
+			scalarQueue[i].move();
+	}
+	double scalarTime = secondsSince(begin);
+
+	begin = SDL_GetPerformanceCounter();
+	batch.gather(&batchQueue);
+	for (int t = 0; t < ticks; t++)
+		batch.step();
+	batch.scatter(&batchQueue);
+	double batchTime = secondsSince(begin);
+
+	begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++)
+		batch.move(&inPlaceQueue);
+	double inPlaceTime = secondsSince(begin); // What the game pays each tick.
+
+	begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++) {
+		batch.gather(&gatherQueue);
+		batch.step();
+		batch.scatter(&gatherQueue);
+	}
+	double gatherTime = secondsSince(begin); // What using the vector step on the render queues would cost, since they would need copying through the arrays every tick.
+
+	const int STRIDE = 10; // As PHYSICS_STRIDE in main.cpp.
+	vector<Body> leapQueue = start;
+	begin = SDL_GetPerformanceCounter();
+	for (int t = STRIDE; t <= ticks; t += STRIDE)
+		batch.leap(&leapQueue, t * Body::dt, STRIDE * Body::dt);
+	double leapTime = secondsSince(begin); // What the game pays, moving the level a stride at a time.
+
+	float leapError = 0, tickedError = 0;
+	for (unsigned int i = 0; i < start.size(); i++) {
+		Body::State exact = start[i].stateAt(ticks / STRIDE * STRIDE * Body::dt);
+		leapError = std::max({leapError, std::abs(leapQueue[i].getX() - exact.x), std::abs(leapQueue[i].getY() - exact.y)});
+		exact = start[i].stateAt(ticks * Body::dt);
+		tickedError = std::max({tickedError, std::abs(scalarQueue[i].getX() - exact.x), std::abs(scalarQueue[i].getY() - exact.y)});
+	} // Against the closed-form path.
+
+	float forwardError = std::max({maxDifference(scalarQueue, batchQueue), maxDifference(scalarQueue, inPlaceQueue), maxDifference(scalarQueue, gatherQueue)});
+
+	batch.gather(&batchQueue);
+	for (int t = 0; t < ticks; t++)
+		batch.reverseStep();
+	batch.scatter(&batchQueue);
+	float reverseError = maxDifference(start, batchQueue);
+
+	std::cout << "kinematics: " << bodyCount << " bodies, " << ticks << " ticks\n";
+	std::cout << "  Body::move():          " << scalarTime / ticks * 1e6 << " us/tick, " << bodyCount * ticks / scalarTime / 1e6 << " M bodies/s\n";
+	std::cout << "  Kinematics::step():    " << batchTime / ticks * 1e6 << " us/tick, " << bodyCount * ticks / batchTime / 1e6 << " M bodies/s\n";
+	std::cout << "  Kinematics::move():    " << inPlaceTime / ticks * 1e6 << " us/tick, " << bodyCount * ticks / inPlaceTime / 1e6 << " M bodies/s\n";
+	std::cout << "  gather/step/scatter:   " << gatherTime / ticks * 1e6 << " us/tick, " << bodyCount * ticks / gatherTime / 1e6 << " M bodies/s\n";
+	std::cout << "  Kinematics::leap():    " << leapTime / ticks * 1e6 << " us/tick, stepping every " << STRIDE << " ticks\n";
+	std::cout << "  max difference from move(): " << forwardError << ", after reversing every step: " << reverseError << "\n";
+	std::cout << "  off the exact path: " << leapError << " px leaping, " << tickedError << " px ticking\n";
+
+	if (forwardError > 1e-3f || reverseError > 1e-2f) {
+		std::cout << "  Error: the batch integrator drifted from Body::move().\n";
+		return false;
+	}
+	if (leapError > 0.1f) {
+		std::cout << "  Error: leap() strayed from the exact path.\n";
+		return false;
+	}
+	return true;
+}
+
+static Uint32 checksum(const vector<Body>& queue)
+{
+	Uint32 hash = 2166136261u;
+	for (const Body& b : queue) {
+		float fields[4] = {b.getX(), b.getY(), b.getXPrime(), b.getYPrime()};
+		Uint32 bits[4];
+		std::memcpy(bits, fields, sizeof(bits));
+		for (Uint32 word : bits)
+			hash = (hash ^ word) * 16777619u;
+	}
+	return hash;
+} // FNV-1a over the exact bits of every position and velocity.
+
+bool benchmarks::fixedPoint(int bodyCount, int ticks)
+{
+	vector<Body> start = launchBodies(bodyCount);
+	vector<Body> floatQueue = start, floatBatchQueue = start, fixedQueue = start, fixedBatchQueue = start;
+	Kinematics batch;
+
+	Uint64 begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++) {
+		for (unsigned int i = 0; i < floatQueue.size(); i++)
+			floatQueue[i].move();
+	}
+	double floatTime = secondsSince(begin);
+
+	begin = SDL_GetPerformanceCounter();
+	batch.gather(&floatBatchQueue);
+	for (int t = 0; t < ticks; t++)
+		batch.step();
+	batch.scatter(&floatBatchQueue);
+	double floatBatchTime = secondsSince(begin);
+
+	Body::setFixedPoint(true);
+	begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++) {
+		for (unsigned int i = 0; i < fixedQueue.size(); i++)
+			fixedQueue[i].move();
+	}
+	double fixedTime = secondsSince(begin);
+
+	begin = SDL_GetPerformanceCounter();
+	batch.gather(&fixedBatchQueue);
+	for (int t = 0; t < ticks; t++)
+		batch.step();
+	batch.scatter(&fixedBatchQueue);
+	double fixedBatchTime = secondsSince(begin);
+
+	vector<Body> replayQueue = fixedQueue;
+	for (int t = 0; t < ticks; t++) {
+		for (unsigned int i = 0; i < replayQueue.size(); i++)
+			replayQueue[i].move(-1);
+	}
+	float rewindError = maxDifference(start, replayQueue);
+	for (int t = 0; t < ticks; t++) {
+		for (unsigned int i = 0; i < replayQueue.size(); i++)
+			replayQueue[i].move();
+	} // Rewinding and then replaying should retrace the same path to the last bit.
+	Body::setFixedPoint(false);
+
+	std::cout << "fixedpoint: " << bodyCount << " bodies, " << ticks << " ticks\n";
+	std::cout << "  float Body::move():        " << floatTime / ticks * 1e6 << " us/tick\n";
+	std::cout << "  float Kinematics::step():  " << floatBatchTime / ticks * 1e6 << " us/tick\n";
+	std::cout << "  Q16.16 Body::move():       " << fixedTime / ticks * 1e6 << " us/tick\n";
+	std::cout << "  Q16.16 Kinematics::step(): " << fixedBatchTime / ticks * 1e6 << " us/tick\n";
+	std::cout << "  max difference from float: " << maxDifference(floatQueue, fixedQueue) << ", after rewinding: " << rewindError << "\n";
+	std::cout << "  checksum: " << std::hex << checksum(fixedQueue) << std::dec << " (should match on every build)\n";
+
+	if (!identical(fixedQueue, fixedBatchQueue) || !identical(fixedQueue, replayQueue) || rewindError > 1e-3f) {
+		std::cout << "  Error: the fixed-point results depended on how they were stepped.\n";
+		return false;
+	}
+	return true;
+}
+
+bool benchmarks::sleeping(int surfaceCount, int ticks)
+{
+	vector<Surface> awakeQueue = scatterSurfaces(surfaceCount, 1400, 750);
+	vector<Surface> sleepingQueue = awakeQueue;
+	int moving = 0;
+	for (Surface& s : sleepingQueue) {
+		s.sleep();
+		moving += !s.isAsleep();
+	}
+	Kinematics kinematics;
+
+	Uint64 begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++) {
+		kinematics.move(&awakeQueue);
+		for (Surface& s : awakeQueue)
+			s.ifOnEdgeBounce();
+	}
+	double awakeTime = secondsSince(begin);
+
+	begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++) {
+		kinematics.move(&sleepingQueue);
+		for (int i : kinematics.awake(&sleepingQueue))
+			sleepingQueue[i].ifOnEdgeBounce();
+	}
+	double sleepingTime = secondsSince(begin); // The same loops the game runs over the surface queue each tick.
+
+	std::cout << "sleeping: " << surfaceCount << " surfaces, " << moving << " of them moving, " << ticks << " ticks\n";
+	std::cout << "  all awake:         " << awakeTime / ticks * 1e6 << " us/tick\n";
+	std::cout << "  static ones asleep: " << sleepingTime / ticks * 1e6 << " us/tick\n";
+
+	if (!identical(awakeQueue, sleepingQueue)) {
+		std::cout << "  Error: putting static surfaces to sleep changed where things ended up.\n";
+		return false;
+	}
+	return true;
+}
+
+bool benchmarks::integrators(int bodyCount, float seconds)
+{
+	const Body::Integrator methods[] = {Body::SEMI_IMPLICIT_EULER, Body::VELOCITY_VERLET, Body::RK4};
+	const char* names[] = {"semi-implicit Euler", "velocity Verlet", "RK4"};
+	const float timesteps[] = {0.01, 0.1, 1.0};
+	vector<Body> start = launchBodies(bodyCount);
+	bool passed = true;
+
+	std::cout << "integrators: " << bodyCount << " bodies, " << seconds << " simulated seconds\n";
+	for (int m = 0; m < 3; m++) {
+		for (float dt : timesteps) {
+			vector<Body> queue = start;
+			int steps = std::lround(seconds / dt);
+
+			Uint64 begin = SDL_GetPerformanceCounter();
+			for (int s = 0; s < steps; s++) {
+				for (unsigned int i = 0; i < queue.size(); i++)
+					queue[i].step(dt, methods[m]);
+			}
+			double elapsed = secondsSince(begin);
+
+			double worst = 0, farthest = 0, t = steps * double(dt);
+			for (unsigned int i = 0; i < queue.size(); i++) {
+				const Body& b = start[i];
+				double x = b.getX() + b.getXPrime() * t + 0.5 * b.getXPrimePrime() * t * t;
+				double y = b.getY() + b.getYPrime() * t + 0.5 * b.getYPrimePrime() * t * t;
+				worst = std::max({worst, std::abs(queue[i].getX() - x), std::abs(queue[i].getY() - y)});
+				farthest = std::max({farthest, std::abs(x), std::abs(y)});
+			} // Acceleration is constant between collisions, so the true path is a parabola.
+			double rounding = 2 * steps * farthest * FLT_EPSILON; // What float rounding alone can add up to over the run.
+
+			std::cout << "  " << names[m] << ", dt=" << dt << ": " << elapsed / seconds * 1e6 << " us per simulated second, max error " << worst << " px\n";
+			if (methods[m] != Body::SEMI_IMPLICIT_EULER && worst > rounding) {
+				std::cout << "  Error: " << names[m] << " strayed from the closed-form path.\n";
+				passed = false;
+			}
+		}
+	}
+	return passed;
+}
+
+bool benchmarks::timeJump(int bodyCount, float seconds)
+{
+	vector<Body> start = launchBodies(bodyCount);
+	vector<Body> tickedQueue = start, jumpedQueue = start, rewoundQueue = start;
+	int ticks = std::lround(seconds / Body::dt);
+
+	Uint64 begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++) {
+		for (unsigned int i = 0; i < tickedQueue.size(); i++) {
+			tickedQueue[i].step(Body::dt, Body::VELOCITY_VERLET);
+			tickedQueue[i].ifOnEdgeBounce();
+		}
+	}
+	double tickedTime = secondsSince(begin);
+
+	begin = SDL_GetPerformanceCounter();
+	for (unsigned int i = 0; i < jumpedQueue.size(); i++)
+		jumpedQueue[i].advanceBouncing(seconds);
+	double jumpedTime = secondsSince(begin);
+
+	begin = SDL_GetPerformanceCounter();
+	for (unsigned int i = 0; i < rewoundQueue.size(); i++) {
+		rewoundQueue[i].advanceTo(seconds);
+		rewoundQueue[i].advanceTo(0);
+	}
+	double rewoundTime = secondsSince(begin);
+
+	float rewindError = maxDifference(start, rewoundQueue), escaped = 0, drift = 0;
+	for (unsigned int i = 0; i < jumpedQueue.size(); i++) {
+		const Body& b = jumpedQueue[i];
+		float w = b.getWidth() * b.getSize(), h = b.getHeight() * b.getSize();
+		if (start[i].getX() <= 1400 - w && start[i].getY() <= 750 - h)
+			escaped = std::max({escaped, -b.getX(), b.getX() - (1400 - w), -b.getY(), b.getY() - (750 - h)}); // Bodies launched past an edge can stay there, as they would with ifOnEdgeBounce().
+		drift += std::abs(b.getX() - tickedQueue[i].getX()) + std::abs(b.getY() - tickedQueue[i].getY());
+	}
+
+	std::cout << "timejump: " << bodyCount << " bouncing bodies, " << seconds << " simulated seconds\n";
+	std::cout << "  tick by tick:      " << tickedTime * 1e3 << " ms\n";
+	std::cout << "  advanceBouncing(): " << jumpedTime * 1e3 << " ms, mean difference from ticking " << drift / bodyCount << " px (ticking overshoots each edge by up to one step)\n";
+	std::cout << "  advanceTo() and back: " << rewoundTime * 1e3 << " ms, max error " << rewindError << "\n";
+
+	if (escaped > 0.01f || rewindError > 1e-2f) {
+		std::cout << "  Error: time jumps left a body " << escaped << " px outside the edges or " << rewindError << " away from where it started.\n";
+		return false;
+	}
+	return true;
+}
+
+static double stressTicks(vector<Surface>* queue, JobSystem* jobs, int ticks, vector<pair<int,int>>* pairs, double* pairTime)
+{
+	Kinematics kinematics;
+	SpatialGrid grid;
+	vector<SDL_Rect> reach(queue->size());
+	kinematics.setJobSystem(jobs);
+	double integrateTime = 0;
+	*pairTime = 0;
+
+	for (int t = 0; t < ticks; t++) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		kinematics.move(queue);
+		integrateTime += secondsSince(start);
+
+		grid.sync(queue);
+		start = SDL_GetPerformanceCounter();
+		for (unsigned int i = 0; i < queue->size(); i++) {
+			const Surface& s = queue->at(i);
+			reach[i] = {static_cast<int>(s.getX()) - 8, static_cast<int>(s.getY()) - 8, static_cast<int>(s.getWidth()*s.getSize()) + 16, static_cast<int>(s.getHeight()*s.getSize()) + 16};
+		}
+		grid.pairs(reach, pairs, jobs);
+		*pairTime += secondsSince(start);
+	}
+	return integrateTime;
+} // Every surface against every other, as a stress level with tens of thousands of movers would need. The grid sync isn't timed, since it stays on one thread.
+
+bool benchmarks::jobs(int bodyCount, int ticks)
+{
+	float worldWidth = 1400, worldHeight = 750;
+	while (worldWidth * worldHeight < bodyCount * 35000.0f) {
+		worldWidth *= 2;
+		worldHeight *= 1.5;
+	}
+
+	vector<Surface> start = scatterSurfaces(bodyCount, worldWidth, worldHeight);
+	for (unsigned int i = 0; i < start.size(); i++) {
+		if (i % 3 == 0)
+			start[i].setXPrime((static_cast<int>(i) % 41) - 20);
+	} // More movers than the hand-made levels have, so integration isn't all static platforms.
+
+	vector<Surface> serialQueue = start;
+	vector<pair<int,int>> serialPairs;
+	double serialPairTime;
+	double serialTime = stressTicks(&serialQueue, nullptr, ticks, &serialPairs, &serialPairTime);
+	int cores = std::thread::hardware_concurrency();
+	bool passed = true;
+
+	std::cout << "jobs: " << bodyCount << " surfaces, " << ticks << " ticks, " << cores << " cores\n";
+	std::cout << "  single-threaded: integrate " << serialTime / ticks * 1e6 << " us/tick, pairs " << serialPairTime / ticks * 1e6 << " us/tick, " << serialPairs.size() << " pairs\n";
+
+	for (int threads = 1; threads <= std::max(cores, 4); threads *= 2) {
+		JobSystem pool(threads);
+		vector<Surface> queue = start;
+		vector<pair<int,int>> pairs;
+		double pairTime;
+		double integrateTime = stressTicks(&queue, &pool, ticks, &pairs, &pairTime);
+
+		std::cout << "  " << threads << " threads: integrate " << integrateTime / ticks * 1e6 << " us/tick (" << serialTime / integrateTime << "x), pairs " << pairTime / ticks * 1e6 << " us/tick (" << serialPairTime / pairTime << "x)\n";
+		if (!identical(queue, serialQueue) || pairs != serialPairs) {
+			std::cout << "  Error: " << threads << " threads gave different results from the single-threaded run.\n";
+			passed = false;
+		}
+	} // Always tries a few threads, even on fewer cores, so the determinism check still sees chunks stolen and finished out of order.
+	return passed;
+}
+
+bool benchmarks::scaling(int maxEntities, const string& csvPath)
+{
+	if (SDL_Init(SDL_INIT_VIDEO) > 0)
+		std::cout << "SDL SYSTEM FAILURE. ERROR: " << SDL_GetError() << '\n';
+	if (!(IMG_Init(IMG_INIT_PNG)))
+		std::cout << "IMG_init has failed. Error: " << SDL_GetError() << '\n';
+	RenderWindow window("Stress test", 1400, 750);
+
+	Entity platformSprite(0, 0, 341, 48, window.loadTexture("res/gfx/objects/platform2.png"));
+	Entity redPlatformSprite(0, 0, 341, 48, window.loadTexture("res/gfx/objects/redplatform.png"));
+	Entity missileSprite(0, 0, 123, 39, window.loadTexture("res/gfx/objects/missile.png"));
+	Entity boardSprite(0, 0, 711, 368, window.loadTexture("res/gfx/decoration/gamma.png"));
+	Entity background(0, 0, 100, 100, window.loadTexture("res/gfx/backgrounds/Stars.png"));
+	Entity door(0, 0, 190, 313, nullptr), camera(0, 0, 200, 200, nullptr), simulCamera(0, 0, 200, 200, nullptr);
+	Body player(Entity(100, 100, 198, 336, window.loadTexture("res/gfx/miscellaneous/pixelpic2.png")), 0, 0, false, false, 0.4);
+
+	Surface solidPlatform(platformSprite, true, true, true, true, 0);
+	Surface semisolidPlatform(platformSprite, false, false, false, true, 0);
+	Surface dmgPlatform(redPlatformSprite, true, true, true, true, 1);
+	Surface missile(missileSprite, false, false, false, false, 1);
+	Body movingBody(boardSprite, 0, 0, false, true, 0.5);
+	solidPlatform.makePlatform();
+	semisolidPlatform.makePlatform();
+	solidPlatform.setBouncy();
+	semisolidPlatform.setBouncy();
+	dmgPlatform.makePlatform();
+	dmgPlatform.setBouncy();
+	const PrototypeRegistry prototypes = {{"backgrounda", &background}, {"solidPlatform", &solidPlatform}, {"semisolidPlatform", &semisolidPlatform}, {"dmgPlatform", &dmgPlatform}, {"missile", &missile}, {"movingBody", &movingBody}}; // The same sprites and flags as the prototypes of the same names in main.cpp. Their velocities come from the level, so those don't have to match.
+
+	vector<Entity> backgroundQueue, decorationQueue, objectQueue;
+	vector<Body> bodyQueue;
+	vector<Surface> surfaceQueue;
+	vector<float> decorationSize, objectSize, bodySize, surfaceSize;
+	vector<bool> bodyHasHitbox;
+	vector<char> animationCode;
+	QueueSet queues = {&backgroundQueue, &decorationQueue, &objectQueue, &bodyQueue, &surfaceQueue, &decorationSize, &objectSize, &bodySize, &surfaceSize, &bodyHasHitbox, &animationCode};
+
+	std::ofstream csv(csvPath);
+	if (!csv) {
+		std::cout << "Failed to write benchmark results. Error: " << csvPath << '\n';
+		return false;
+	}
+	csv << "entities,ticks per second,load ms,render us,integrate us,collide us,player contacts\n";
+	std::cout << "scaling: 40% static platforms, 20% moving platforms, 20% bouncy bodies, 10% hazards, 10% missiles\n";
+	std::cout << "  entities   ticks/s   render us  integrate us  collide us\n";
+	bool passed = true;
+
+	for (int count = 10; count <= maxEntities; count *= 10) {
+		StressSpec spec;
+		spec.staticSurfaces = count * 4/10;
+		spec.movingPlatforms = count * 2/10;
+		spec.bouncyBodies = count * 2/10;
+		spec.hazards = count / 10;
+		spec.missiles = count - spec.staticSurfaces - spec.movingPlatforms - spec.bouncyBodies - spec.hazards;
+		Level level;
+		if (!generateLevel(spec, prototypes, level))
+			return false;
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		if (!loadLevel(level, player, queues, door, camera, simulCamera))
+			return false;
+		double loadTime = secondsSince(start);
+		if (static_cast<int>(bodyQueue.size()) != spec.bouncyBodies || static_cast<int>(surfaceQueue.size()) != count - spec.bouncyBodies) {
+			std::cout << "  Error: loadLevel() put " << bodyQueue.size() + surfaceQueue.size() << " of the " << count << " generated elements in the queues.\n";
+			passed = false;
+		}
+
+		Kinematics kinematics;
+		SpatialGrid surfaceGrid, bodyGrid;
+		double renderTime = 0, integrateTime = 0, collideTime = 0;
+		long long hits = 0;
+		int ticks = std::max(20, std::min(2000, 200000 / count));
+
+		for (int t = 0; t < ticks; t++) {
+			start = SDL_GetPerformanceCounter();
+			window.clear();
+			window.renderFullscreen(background);
+			for (unsigned int i = 0; i < bodyQueue.size(); i++)
+				window.render(bodyQueue[i], bodySize[i]);
+			for (unsigned int i = 0; i < surfaceQueue.size(); i++) {
+				if (animationCode[i] == 'M')
+					window.render(surfaceQueue[i], surfaceSize[i], 1.0, 1.0, true, false, surfaceQueue[i].getTilt());
+				else
+					window.render(surfaceQueue[i], surfaceSize[i]);
+			}
+			window.render(player, 0.4);
+			window.display();
+			renderTime += secondsSince(start);
+
+			start = SDL_GetPerformanceCounter();
+			kinematics.move(&bodyQueue);
+			for (unsigned int i = 0; i < bodyQueue.size(); i++) {
+				if (bodyQueue[i].isBouncy())
+					bodyQueue[i].ifOnEdgeBounce();
+			}
+			kinematics.move(&surfaceQueue);
+			for (unsigned int i = 0; i < surfaceQueue.size(); i++) {
+				Surface& s = surfaceQueue[i];
+				if (s.followsPath())
+					s.followPath(Body::dt);
+				else if (s.isBouncy())
+					s.ifOnEdgeBounce();
+				if (animationCode[i] == 'M' && (s.getX() < -200 || s.getX() > 1600))
+					s.setCoords(s.getX() < 0 ? 1600 : -200, s.getY());
+			} // Missiles that leave the screen come back round instead of being removed, so the count stays the same throughout.
+			integrateTime += secondsSince(start);
+
+			start = SDL_GetPerformanceCounter();
+			float stepX = 30 * std::cos(t * 0.05f), stepY = 10 * std::sin(t * 0.05f);
+			player.setCoords(700 + 600 * std::sin(t * 0.01f), 375 + 300 * std::cos(t * 0.013f)); // Wanders over the whole screen.
+			SDL_Rect reach = {static_cast<int>(player.getX()) - 64, static_cast<int>(player.getY()) - 64, static_cast<int>(player.getWidth()*player.getSize()) + 128, static_cast<int>(player.getHeight()*player.getSize()) + 128};
+			bodyGrid.sync(&bodyQueue, &bodyHasHitbox);
+			surfaceGrid.sync(&surfaceQueue);
+			for (int i : bodyGrid.query(reach)) {
+				int side = 0;
+				if (sweptCollision(player, stepX, stepY, bodyQueue[i], &side) < 1)
+					hits++;
+			}
+			for (int i : surfaceGrid.query(reach)) {
+				int side = 0;
+				if (sweptCollision(player, stepX, stepY, surfaceQueue[i], &side) < 1 && surfaceQueue[i].isSolid(side))
+					hits++;
+				if (surfaceQueue[i].getDamage() > 0 && sdlCollided(player, surfaceQueue[i]))
+					hits++;
+			}
+			for (unsigned int i = 0; i < surfaceQueue.size(); i++) {
+				int side = 0;
+				if (animationCode[i] == 'M' && (sdlCollided(player, surfaceQueue[i]) || sweptCollision(surfaceQueue[i], surfaceQueue[i].getXPrime()*Body::dt, surfaceQueue[i].getYPrime()*Body::dt, player, &side) < 1))
+					hits++;
+			} // Every missile checks the player, as in the game's render loop.
+			collideTime += secondsSince(start);
+		} // The phases run in the same order as the game loop: render and animate, integrate, then collide.
+
+		double ticksPerSecond = ticks / (renderTime + integrateTime + collideTime);
+		std::cout << "  " << std::left << std::setw(11) << count << std::setw(10) << static_cast<int>(ticksPerSecond) << std::setw(11) << static_cast<int>(renderTime / ticks * 1e6)
+			<< std::setw(14) << static_cast<int>(integrateTime / ticks * 1e6) << std::setw(12) << static_cast<int>(collideTime / ticks * 1e6) << string(std::max(1, static_cast<int>(std::log10(ticksPerSecond) * 8)), '#') << std::right << '\n';
+		csv << count << ',' << ticksPerSecond << ',' << loadTime * 1e3 << ',' << renderTime / ticks * 1e6 << ',' << integrateTime / ticks * 1e6 << ',' << collideTime / ticks * 1e6 << ',' << hits << '\n';
+	}
+
+	std::cout << "  (bars are log10 ticks/s; " << csvPath << " also has the load times and contact counts)\n";
+	window.cleanUp();
+	SDL_Quit();
+	return passed;
+}
+
+static float floatLorentzFactor(float v)
+{
+	float c = SPEED_OF_LIGHT;
+	return 1/sqrt(1 - (v*v)/(c*c));
+}
+
+static float floatDopplerFactor(float lorentz)
+{
+	float beta = 1 - (1/(lorentz*lorentz));
+	return sqrt((1 - beta)/(1 + beta));
+} // How main.cpp worked the factors out before RelativityEngine, kept to measure against.
+
+bool benchmarks::relativityFactors(int ticks, int entityCount)
+{
+	struct Reference
+	{
+		double beta, gamma, doppler;
+	};
+	const Reference references[] = {
+		{0.0001, 1.00000000500000003750, 0.999999990000000050000},
+		{0.6, 1.25, 0.685994340570035349515},
+		{0.65, 1.31590338991953797677, 0.637161985236548748114},
+		{0.8, 1.66666666666666666667, 0.468521285665818196572},
+		{0.85, 1.89831599150499799070, 0.401376441629925168294},
+		{0.9, 2.29415733870561765907, 0.323994406881674015738},
+		{0.99, 7.08881205008335900765, 0.100249675684637535454},
+		{0.999999, 707.106957963309112326, 0.00100000024999996874988}
+	}; // Worked out to 40 digits with Python's decimal module. The game's frames are between 0.6c and 0.9c apart.
+	bool passed = true;
+
+	std::cout << "relativity: factors against 40-digit references\n";
+	for (const Reference& r : references) {
+		FrameOfReference s = {true, 0}, sPrime = {false, r.beta * SPEED_OF_LIGHT};
+		double beta = relativity::beta(s, sPrime);
+		double gammaError = std::abs(relativity::lorentzFactor(beta) - r.gamma) / r.gamma;
+		double dopplerError = std::abs(relativity::dopplerFactor(beta) - r.doppler) / r.doppler;
+		float oldGamma = floatLorentzFactor(sPrime.velocity);
+		double oldGammaError = std::abs(oldGamma - r.gamma) / r.gamma;
+		double oldDopplerError = std::abs(floatDopplerFactor(oldGamma) - r.doppler) / r.doppler;
+		double tolerance = 8 * DBL_EPSILON * r.gamma * r.gamma; // Rounding beta once is magnified by gamma's sensitivity to it, beta^2 gamma^2.
+
+		std::cout << "  beta " << r.beta << ": gamma error " << gammaError << " (float: " << oldGammaError << "), doppler error " << dopplerError << " (float: " << oldDopplerError << ")\n";
+		if (gammaError > tolerance || dopplerError > tolerance) {
+			std::cout << "  Error: the factors at beta " << r.beta << " are further from the reference than rounding accounts for.\n";
+			passed = false;
+		}
+	}
+
+	FrameOfReference train = {true, 0.7 * SPEED_OF_LIGHT}, camera = {false, 0.1 * SPEED_OF_LIGHT};
+	double oldGamma = 0, oldShift = 0;
+	Uint64 begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++) {
+		if (t % (ticks / 12) == 0)
+			train.velocity += 0.005 * SPEED_OF_LIGHT;
+		float gamma = floatLorentzFactor(camera.velocity - train.velocity);
+		oldGamma += gamma;
+		oldShift += Uint8(-99.6*floatDopplerFactor(gamma) + 139.84);
+		oldShift += Uint8(-9.96*floatDopplerFactor(gamma) + 13.984);
+	}
+	double oldTime = secondsSince(begin);
+
+	train.velocity = 0.7 * SPEED_OF_LIGHT;
+	RelativityEngine engine;
+	double engineGamma = 0, engineShift = 0;
+	begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++) {
+		if (t % (ticks / 12) == 0)
+			train.velocity += 0.005 * SPEED_OF_LIGHT;
+		const RelativityEngine::Factors& f = engine.between(train, camera);
+		engineGamma += f.gamma;
+		engineShift += f.redshift + f.blueshift;
+	}
+	double engineTime = secondsSince(begin); // Twelve levels' worth of velocity changes, as the train speeds up between levels.
+
+	std::cout << "  recomputed in float every tick: " << oldTime / ticks * 1e9 << " ns/tick, mean gamma " << oldGamma / ticks << ", mean shift " << oldShift / ticks << "\n";
+	std::cout << "  RelativityEngine:               " << engineTime / ticks * 1e9 << " ns/tick, mean gamma " << engineGamma / ticks << ", mean shift " << engineShift / ticks << ", " << engine.recomputations() << " recomputations in " << ticks << " ticks\n";
+	if (std::abs(oldShift - engineShift) > ticks) {
+		std::cout << "  Error: the memoized doppler shift differs from the old one by more than a colour step.\n";
+		passed = false;
+	}
+
+	vector<Body> bodies;
+	vector<Surface> surfaces = scatterSurfaces(entityCount, 1400, 750);
+	for (Surface& surface : surfaces)
+		surface.setXPrime(std::rand() % 121 - 60);
+	RelativisticKinematics lorentz;
+	const RelativityEngine::Factors& frame = engine.between(train, camera);
+	lorentz.setFrame(frame);
+
+	begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < 100; t++)
+		lorentz.update(&bodies, &surfaces);
+	double batchTime = secondsSince(begin) / 100;
+
+	double worst = 0, scalarSum = 0;
+	begin = SDL_GetPerformanceCounter();
+	for (const Surface& surface : surfaces)
+		scalarSum += lorentz.contraction(surface);
+	double scalarTime = secondsSince(begin);
+
+	for (int i = 0; i < entityCount; i++) {
+		double u = std::max(-0.999, std::min(0.999, surfaces[i].getXPrime() / double(GAME_SPEED_OF_LIGHT)));
+		double w = relativity::addVelocities(-frame.beta, u);
+		double k = std::max(0.5, frame.gamma * std::sqrt((1 - w)*(1 + w)));
+		worst = std::max(worst, std::abs(lorentz.surfaceContraction(i) - k) / k);
+	} // The same factors in double, from the scalar velocity addition.
+
+	std::cout << "  contraction of " << entityCount << " surfaces: " << batchTime * 1e6 << " us batched, " << scalarTime * 1e6 << " us one at a time, max relative error " << worst << " (" << scalarSum / entityCount << ")\n";
+	if (worst > 1e-5) {
+		std::cout << "  Error: the batched contraction factors strayed from the double-precision ones.\n";
+		passed = false;
+	}
+
+	train.velocity = 0.7 * SPEED_OF_LIGHT;
+	train.properTime = 0;
+	long long trainTicks = 0;
+	begin = SDL_GetPerformanceCounter();
+	for (int t = 0; t < ticks; t++)
+		trainTicks += engine.advance(train, camera);
+	double clockTime = secondsSince(begin);
+	double gamma = engine.between(camera, train).gamma;
+
+	std::cout << "  train clock seen from the camera: " << trainTicks << " train ticks in " << ticks << " (gamma " << gamma << "), " << clockTime / ticks * 1e9 << " ns/tick\n";
+	if (std::abs(trainTicks - ticks / gamma) > 1) {
+		std::cout << "  Error: the train's proper time drifted from the camera's time over gamma.\n";
+		passed = false;
+	} // Runs as fast as the loop can go, where the old dilation slept through every tick.
+	return passed;
+}
+
+bool benchmarks::timers(int timerCount, int ticks)
+{
+	struct Polled
+	{
+		int target, period;
+	};
+	vector<Polled> polled;
+	TimerWheel wheel;
+	std::srand(44);
+	for (int i = 0; i < timerCount; i++) {
+		int delay = 1 + std::rand() % (ticks/2), period = (i % 4 == 0) ? 100 + std::rand() % 12000 : 0;
+		polled.push_back({delay, period});
+		wheel.start(i, delay, period);
+	} // Mostly one-shots, like the invincibility and camera timeouts, with the rest repeating on hazard-like periods.
+
+	long long polledFired = 0, polledSum = 0;
+	Uint64 begin = SDL_GetPerformanceCounter();
+	for (int t = 1; t <= ticks; t++) {
+		for (int i = 0; i < timerCount; i++) {
+			if (t == polled[i].target) {
+				polledFired++;
+				polledSum += static_cast<long long>(i) * t;
+				polled[i].target = (polled[i].period > 0) ? t + polled[i].period : -1;
+			}
+		}
+	}
+	double polledTime = secondsSince(begin); // The targetTime checks main.cpp used to make, one per timer per tick.
+
+	long long wheelFired = 0, wheelSum = 0;
+	TimerWheel::Fired fired;
+	begin = SDL_GetPerformanceCounter();
+	for (int t = 1; t <= ticks; t++) {
+		wheel.advance();
+		while (wheel.pop(&fired)) {
+			wheelFired++;
+			wheelSum += static_cast<long long>(fired.kind) * t;
+		}
+	}
+	double wheelTime = secondsSince(begin);
+
+	std::cout << "timers: " << timerCount << " timers, " << ticks << " ticks, " << wheelFired << " fired\n";
+	std::cout << "  polled: " << polledTime / ticks * 1e6 << " us/tick\n";
+	std::cout << "  wheel:  " << wheelTime / ticks * 1e6 << " us/tick\n";
+
+	if (wheelFired != polledFired || wheelSum != polledSum) {
+		std::cout << "  Error: the timer wheel fired " << wheelFired << " timers where polling fired " << polledFired << ", or fired them on different ticks.\n";
+		return false;
+	}
+	return true;
+}
+
+bool benchmarks::lightDelay(int entityCount, int ticks)
+{
+	vector<Surface> surfaces;
+	vector<Body> bodies;
+	std::srand(46);
+	for (int i = 0; i < entityCount; i++) {
+		Entity sprite(std::rand() % 1400, std::rand() % 750, 100, 48, nullptr);
+		surfaces.push_back(Surface(sprite, true, true, true, true));
+		surfaces.back().setXPrime((std::rand() % 121) - 60);
+		surfaces.back().setYPrime((std::rand() % 61) - 30);
+	} // Straight-line movers, slower than light, so where each was seen can be worked out exactly.
+	Body player(Entity(700, 375, 32, 64, nullptr), 0, 0);
+	vector<Surface> start = surfaces;
+	Kinematics kinematics;
+	LightDelay delay;
+	float c = GAME_SPEED_OF_LIGHT * Body::dt;
+	delay.setObserver(700, 375, c);
+
+	double updateTime = 0;
+	for (int t = 1; t <= ticks; t++) {
+		kinematics.move(&surfaces);
+		Uint64 begin = SDL_GetPerformanceCounter();
+		delay.update(&bodies, &surfaces, player, t);
+		updateTime += secondsSince(begin);
+	}
+
+	double worst = 0;
+	int checked = 0;
+	for (int i = 0; i < entityCount && i < delay.tracked(); i++) {
+		double vx = start[i].getXPrime() * Body::dt, vy = start[i].getYPrime() * Body::dt;
+		double dx = surfaces[i].getX() - 700, dy = surfaces[i].getY() - 375;
+		double a = vx*vx + vy*vy - c*c, b = dx*vx + dy*vy, d = dx*dx + dy*dy;
+		double lag = (b - std::sqrt(b*b - a*d)) / a; // How long ago the light now reaching the observer left it: |d - v*lag| = c*lag.
+		if (lag > (LightDelay::SAMPLES - 1) * LightDelay::STRIDE)
+			continue;
+		double x = surfaces[i].getX() - vx*lag, y = surfaces[i].getY() - vy*lag;
+		pair<float,float> offset = delay.surfaceOffset(i);
+		worst = std::max(worst, std::hypot(surfaces[i].getX() + offset.first - x, surfaces[i].getY() + offset.second - y));
+		checked++;
+	}
+
+	std::cout << "lightdelay: " << entityCount << " moving surfaces, " << delay.tracked() << " tracked in " << delay.memory() / 1024 << " KB, " << ticks << " ticks\n";
+	std::cout << "  update: " << updateTime / ticks * 1e6 << " us/tick\n";
+	std::cout << "  " << checked << " retarded positions checked against the exact ones, max error " << worst << " px\n";
+	if (worst > 0.5) {
+		std::cout << "  Error: the retarded positions are more than half a pixel from where the light left them.\n";
+		return false;
+	}
+	return true;
+}
+
+bool benchmarks::aberration(int columns, int builds)
+{
+	Aberration mesh(1400, 750, columns);
+	double buildTime = 0;
+	for (int k = 0; k < builds; k++) {
+		Uint64 begin = SDL_GetPerformanceCounter();
+		mesh.build((k % 2) ? -0.6f : -0.605f);
+		buildTime += secondsSince(begin);
+	} // Alternating, so that every build does the work, as if the frame changed every frame.
+
+	int across = columns + 1, rows = mesh.getRows();
+	const vector<SDL_Vertex>& v = mesh.vertices();
+	double worst = 0, sag = 0;
+	for (int j = 0; j <= rows; j++) {
+		for (int i = 0; i < across; i++) {
+			const SDL_Vertex& p = v[j*across + i];
+			worst = std::max(worst, std::abs(p.position.x - mesh.apparentX(p.tex_coord.x * 1400, p.tex_coord.y * 750)));
+		}
+	}
+	for (int j = 0; j < rows; j++) {
+		for (int i = 0; i < columns; i++) {
+			const SDL_Vertex* corner[4] = {&v[j*across + i], &v[j*across + i + 1], &v[(j+1)*across + i], &v[(j+1)*across + i + 1]};
+			double x = 0, u = 0, w = 0;
+			for (const SDL_Vertex* c : corner) {
+				x += c->position.x / 4;
+				u += c->tex_coord.x * 1400 / 4;
+				w += c->tex_coord.y * 750 / 4;
+			}
+			sag = std::max(sag, std::abs(x - mesh.apparentX(u, w)));
+		}
+	} // The middle of each cell, where drawing it as flat triangles is furthest from the curve.
+
+	std::cout << "aberration: " << columns << "x" << rows << " cells, " << v.size() << " vertices, " << mesh.indices().size() / 3 << " triangles, " << builds << " builds\n";
+	std::cout << "  build: " << buildTime / builds * 1e6 << " us, " << buildTime / builds * 60 * 100 << "% of a 60 fps frame\n";
+	std::cout << "  vertices off by at most " << worst << " px, cell centres by " << sag << " px\n";
+	if (worst > 0.5) {
+		std::cout << "  Error: the SIMD mesh is more than half a pixel from the double-precision warp.\n";
+		return false;
+	}
+	return true;
+}
+
+static void drawScene(RenderWindow& window, Entity& background, vector<Surface>& surfaces, float beta)
+{
+	window.renderFullscreen(background);
+	window.beginAberration(beta);
+	for (Surface& s : surfaces)
+		window.render(s, 0.5);
+	window.endAberration();
+} // What main.cpp draws for each view: the background plain, and the level through the aberration mesh, which does nothing at beta = 0.
+
+bool benchmarks::aberrationFrames(int surfaceCount, int frames)
+{
+	if (SDL_Init(SDL_INIT_VIDEO) > 0)
+		std::cout << "SDL SYSTEM FAILURE. ERROR: " << SDL_GetError() << '\n';
+	if (!(IMG_Init(IMG_INIT_PNG)))
+		std::cout << "IMG_init has failed. Error: " << SDL_GetError() << '\n';
+	RenderWindow window("Aberration test", 1400, 750);
+
+	Entity background(0, 0, 100, 100, window.loadTexture("res/gfx/backgrounds/Stars.png"));
+	SDL_Texture* platform = window.loadTexture("res/gfx/objects/platform2.png");
+	vector<Surface> surfaces = scatterSurfaces(surfaceCount, 1400, 750);
+	for (Surface& s : surfaces)
+		s.setTexture(platform);
+
+	double plainTime = 0, warpedTime = 0;
+	for (int k = 0; k < frames; k++) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		window.clear();
+		drawScene(window, background, surfaces, 0);
+		window.display();
+		plainTime += secondsSince(start);
+
+		start = SDL_GetPerformanceCounter();
+		window.clear();
+		drawScene(window, background, surfaces, (k % 2) ? -0.6f : -0.605f);
+		window.display();
+		warpedTime += secondsSince(start);
+	} // Interleaved, so that anything else the machine is doing lands on both alike. The warped frames alternate beta, so the mesh is rebuilt every frame.
+
+	double plain = plainTime / frames * 1e3, warped = warpedTime / frames * 1e3;
+	std::cout << "aberrationFrames: " << surfaceCount << " surfaces at 1400x750, " << frames << " frames each\n";
+	std::cout << "  plain:  " << plain << " ms, " << plain / (1000.0/60) * 100 << "% of a 60 fps frame\n";
+	std::cout << "  warped: " << warped << " ms, " << warped / (1000.0/60) * 100 << "% of a 60 fps frame (render to texture, mesh build and SDL_RenderGeometry add " << warped - plain << " ms)\n";
+	if (warped > 1000.0/60)
+		std::cout << "  The warped frame doesn't fit in 60 fps here. Lower ABERRATION_QUALITY, or see whether the plain one does.\n";
+
+	window.cleanUp();
+	SDL_Quit();
+	return true;
+} // Only reported, not failed, since what a frame costs depends on the graphics driver, and with vsync on both sit at the refresh rate.
+
+bool benchmarks::splitView(int surfaceCount, int frames)
+{
+	if (SDL_Init(SDL_INIT_VIDEO) > 0)
+		std::cout << "SDL SYSTEM FAILURE. ERROR: " << SDL_GetError() << '\n';
+	if (!(IMG_Init(IMG_INIT_PNG)))
+		std::cout << "IMG_init has failed. Error: " << SDL_GetError() << '\n';
+	RenderWindow window("Split view test", 1400, 750);
+
+	Entity background(0, 0, 100, 100, window.loadTexture("res/gfx/backgrounds/Stars.png"));
+	SDL_Texture* platform = window.loadTexture("res/gfx/objects/platform2.png");
+	vector<Surface> surfaces = scatterSurfaces(surfaceCount, 1400, 750);
+	for (Surface& s : surfaces)
+		s.setTexture(platform);
+	const SDL_Rect left = {0, 750 / 4, 1400 / 2, 750 / 2}, right = {1400 / 2, 750 / 4, 1400 / 2, 750 / 2}; // SPLIT_LEFT and SPLIT_RIGHT in main.cpp.
+
+	double oneTime = 0, twoTime = 0;
+	for (int k = 0; k < frames; k++) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		window.clear();
+		drawScene(window, background, surfaces, -0.6f);
+		window.display();
+		oneTime += secondsSince(start);
+
+		start = SDL_GetPerformanceCounter();
+		window.clear();
+		window.setViewport(&left);
+		drawScene(window, background, surfaces, 0);
+		window.setViewport(&right);
+		drawScene(window, background, surfaces, -0.6f);
+		window.setViewport(nullptr);
+		window.display();
+		twoTime += secondsSince(start);
+	} // The single view is the camera's, warped, as it is when the player is watching through it; the split adds the train's, unwarped, beside it.
+
+	double one = oneTime / frames * 1e3, two = twoTime / frames * 1e3;
+	std::cout << "splitView: " << surfaceCount << " surfaces at 1400x750, " << frames << " frames each\n";
+	std::cout << "  one view:  " << one << " ms, " << one / (1000.0/60) * 100 << "% of a 60 fps frame\n";
+	std::cout << "  two views: " << two << " ms, " << two / (1000.0/60) * 100 << "% of a 60 fps frame (" << two / std::max(one, 1e-9) << "x)\n";
+	if (two > 1000.0/60)
+		std::cout << "  The split view doesn't fit in 60 fps here.\n";
+
+	window.cleanUp();
+	SDL_Quit();
+	return true;
+} // Reported only, like aberrationFrames().
+
+static int risingCrossings(const vector<Sint16>& samples, int from)
+{
+	int crossings = 0;
+	for (unsigned int n = from + 2; n < samples.size(); n += 2) {
+		if (samples[n - 2] < 0 && samples[n] >= 0)
+			crossings++;
+	}
+	return crossings;
+} // Of the left channel, from frame from/2 on.
+
+bool benchmarks::dopplerAudio(float beta, int seconds)
+{
+	const int RATE = 44100, CHUNK = 2048;
+	const double TONE = 440;
+	DopplerAudio audio;
+	vector<Sint16> block(2*CHUNK), original;
+	double phase = 0;
+	auto play = [&](int chunks, vector<Sint16>* out) {
+		for (int k = 0; k < chunks; k++) {
+			for (int n = 0; n < CHUNK; n++) {
+				block[2*n] = block[2*n + 1] = static_cast<Sint16>(16000 * std::sin(phase));
+				phase += 2*3.14159265358979*TONE/RATE;
+			}
+			original = block;
+			audio.process(block.data(), CHUNK);
+			if (out)
+				out->insert(out->end(), block.begin(), block.end());
+		}
+	}; // Mix_OpenAudio(44100, ..., 2, 2048) hands the effect 2048 frames at a time.
+
+	play(RATE/CHUNK, nullptr);
+	bool untouched = block == original && audio.bypassed();
+
+	double gamma = relativity::lorentzFactor(beta), doppler = relativity::dopplerFactor(beta);
+	audio.setTarget(doppler, 1/gamma);
+	play(RATE/CHUNK, nullptr); // Lets the ramp finish.
+	audio.resetLoad();
+	vector<Sint16> shifted;
+	play(seconds*RATE/CHUNK, &shifted);
+	double load = audio.load();
+	double heard = risingCrossings(shifted, shifted.size() - 2*RATE); // Over the last second.
+
+	audio.setTarget(1, 1);
+	int chunksToBypass = 0;
+	while (!audio.bypassed() && chunksToBypass < 10*RATE/CHUNK) {
+		play(1, nullptr);
+		chunksToBypass++;
+	}
+	play(1, nullptr);
+	untouched &= block == original;
+
+	std::cout << "dopplerAudio: beta " << beta << ", pitch " << doppler << ", tempo " << 1/gamma << ", " << seconds << " s of 44.1 kHz stereo in " << CHUNK << "-frame callbacks\n";
+	std::cout << "  process: " << load * 100 << "% of one core\n";
+	std::cout << "  a " << TONE << " Hz tone comes out at " << heard << " Hz, where " << TONE * doppler << " Hz was expected\n";
+	std::cout << "  back to passing the mix through " << chunksToBypass * CHUNK * 1000 / RATE << " ms after relativity was turned off\n";
+	if (!untouched) {
+		std::cout << "  Error: the mix was changed while nothing was being shifted.\n";
+		return false;
+	}
+	if (std::abs(heard / (TONE * doppler) - 1) > 0.01) {
+		std::cout << "  Error: the pitch is more than 1% off.\n";
+		return false;
+	}
+	if (load > 0.02) {
+		std::cout << "  Error: the effect takes more than 2% of a core.\n";
+		return false;
+	}
+	return true;
+}
+
+bool benchmarks::voices(int channels, int seconds)
+{
+	const int RATE = 44100, TICK = 16;
+	if (SDL_Init(SDL_INIT_AUDIO) > 0)
+		std::cout << "SDL SYSTEM FAILURE. ERROR: " << SDL_GetError() << '\n';
+	if (Mix_OpenAudio(RATE, MIX_DEFAULT_FORMAT, 2, 512) < 0) {
+		std::cout << "voices: Error: " << Mix_GetError() << '\n';
+		SDL_Quit();
+		return false;
+	}
+
+	auto silence = [&](int ms) { return vector<Uint8>(RATE/1000 * ms * 4, 0); }; // 16-bit stereo.
+	vector<Uint8> shot = silence(150), crash = silence(400), hum = silence(2000), hurt = silence(200);
+	std::map<string, Mix_Chunk*> chunks = {{"Shot", Mix_QuickLoad_RAW(shot.data(), shot.size())}, {"Crash", Mix_QuickLoad_RAW(crash.data(), crash.size())},
+		{"Hum", Mix_QuickLoad_RAW(hum.data(), hum.size())}, {"Hurt", Mix_QuickLoad_RAW(hurt.data(), hurt.size())}};
+	std::map<string, int> limits = {{"Shot", 4}, {"Crash", 3}, {"Hum", 2}, {"Hurt", 1}};
+
+	bool passed = true;
+	int hurtsRefused = 0, mismatches = 0, overLimit = 0, plays = 0;
+	double playTime = 0, updateTime = 0;
+	{
+		VoiceManager manager(channels);
+		manager.define("Shot", chunks["Shot"], VoiceManager::HAZARD, limits["Shot"], 20);
+		manager.define("Crash", chunks["Crash"], VoiceManager::HAZARD, limits["Crash"]);
+		manager.define("Hum", chunks["Hum"], VoiceManager::AMBIENT, limits["Hum"]);
+		manager.define("Hurt", chunks["Hurt"], VoiceManager::CRITICAL, limits["Hurt"]);
+
+		int ticks = seconds*1000/TICK;
+		for (int t = 0; t < ticks; t++) {
+			Uint64 start = SDL_GetPerformanceCounter();
+			manager.update();
+			updateTime += secondsSince(start);
+
+			start = SDL_GetPerformanceCounter();
+			for (int k = 0; k < 3; k++)
+				manager.play("Shot");
+			for (int k = 0; k < 2; k++)
+				manager.play("Crash");
+			if (t % 40 == 0)
+				manager.play("Hum");
+			plays += 5 + (t % 40 == 0);
+			if (t % 20 == 0) {
+				plays++;
+				if (manager.play("Hurt") < 0)
+					hurtsRefused++;
+			}
+			playTime += secondsSince(start);
+
+			std::map<Mix_Chunk*, int> playing;
+			int heard = 0;
+			for (int ch = 0; ch < manager.channels(); ch++) {
+				if (Mix_Playing(ch)) {
+					playing[Mix_GetChunk(ch)]++;
+					heard++;
+				}
+			}
+			if (heard > manager.inUse() || manager.inUse() > manager.channels())
+				mismatches++; // Something is playing that the manager thinks has a free channel.
+			for (auto& sound : chunks) {
+				if (playing[sound.second] > limits[sound.first])
+					overLimit++;
+			}
+			SDL_Delay(TICK);
+		} // A storm of hazards, far more than the channels can take, with the player being hurt all the while.
+
+		manager.stopAll();
+		if (manager.inUse() != 0 || Mix_Playing(-1) != 0)
+			mismatches++;
+
+		const VoiceManager::Stats& stats = manager.stats();
+		std::cout << "voices: " << channels << " channels, " << seconds << " s at " << 1000/TICK << " ticks/s, " << plays << " sounds asked for\n";
+		std::cout << "  played " << stats.played << ", at most " << stats.peak << " at once; stolen " << stats.stolen << ", dropped " << stats.dropped << ", over limit " << stats.limited << ", cooling " << stats.cooling << '\n';
+		std::cout << "  play: " << playTime / plays * 1e6 << " us each, update: " << updateTime / ticks * 1e6 << " us a tick\n";
+	}
+
+	for (auto& sound : chunks)
+		Mix_FreeChunk(sound.second);
+	Mix_CloseAudio();
+	SDL_Quit();
+
+	if (hurtsRefused > 0) {
+		std::cout << "  Error: " << hurtsRefused << " critical sounds were refused.\n";
+		passed = false;
+	}
+	if (mismatches > 0) {
+		std::cout << "  Error: " << mismatches << " ticks where the mixer and the manager disagreed about which channels were busy.\n";
+		passed = false;
+	}
+	if (overLimit > 0) {
+		std::cout << "  Error: " << overLimit << " times a sound was playing more often than its limit.\n";
+		passed = false;
+	}
+	return passed;
+}
+
+int benchmarks::run(int argc, char* args[])
+{
+	bool all = argc <= 2, passed = true;
+	for (int i = 2; i < argc || all; i++) {
+		string name = all ? "" : args[i];
+		if (all || name == "collision") {
+			passed &= collision(100, 20000);
+			passed &= collision(10000, 2000);
+		}
+		if (all || name == "kinematics") {
+			passed &= kinematics(10000, 2000);
+			passed &= kinematics(100000, 200);
+		}
+		if (all || name == "fixedpoint")
+			passed &= fixedPoint(10000, 2000);
+		if (all || name == "integrators")
+			passed &= integrators(1000, 20);
+		if (all || name == "timejump")
+			passed &= timeJump(1000, 60);
+		if (all || name == "sleeping")
+			passed &= sleeping(100000, 500);
+		if (all || name == "scaling")
+			passed &= scaling(100000, "stress.csv");
+		if (all || name == "relativity")
+			passed &= relativityFactors(1200000, 100000);
+		if (all || name == "lightdelay") {
+			passed &= lightDelay(300, 3000);
+			passed &= lightDelay(2000, 3000);
+		}
+		if (all || name == "aberration") {
+			passed &= aberration(8, 10000);
+			passed &= aberration(32, 10000);
+			passed &= aberration(128, 1000);
+			passed &= aberrationFrames(300, 600);
+		}
+		if (all || name == "splitview")
+			passed &= splitView(300, 600);
+		if (all || name == "doppleraudio") {
+			passed &= dopplerAudio(0.6, 10);
+			passed &= dopplerAudio(0.9, 30);
+		}
+		if (all || name == "voices") {
+			passed &= voices(4, 5);
+			passed &= voices(16, 5);
+		}
+		if (all || name == "timers") {
+			passed &= timers(10, 1000000);
+			passed &= timers(10000, 100000);
+		}
+		if (all || name == "jobs") {
+			passed &= jobs(20000, 100);
+			passed &= jobs(100000, 20);
+		}
+		if (all)
+			break;
+	}
+	return passed ? 0 : 1;
+}
@@ -1,12 +1,35 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <iostream>
+#include <vector>
 #include <cmath>
 
 #include "Entity.hpp"
+#include "Fixed.hpp"
 #include "Body.hpp"
+#include "Path.hpp"
 #include "Surface.hpp"
 
+float Body::dt = 0.01;
+Body::Integrator Body::integrator = Body::SEMI_IMPLICIT_EULER;
+bool Body::fixedPoint = false;
+unsigned int Body::sleepEpoch = 0;
+
+Body::SleepState::SleepState(const SleepState& other)
+: asleep(other.asleep)
+{
+	if (!asleep)
+		sleepEpoch++;
+}
+
+Body::SleepState& Body::SleepState::operator=(const SleepState& other)
+{
+	asleep = other.asleep;
+	if (!asleep)
+		sleepEpoch++;
+	return *this;
+}
+
 Body::Body(Entity e, float x_vel, float y_vel, bool grav, bool b, float s) 
 : Entity(e.getX(), e.getY(), e.getWidth(), e.getHeight(), e.getTexture())
 {
@@ -20,6 +43,8 @@ Body::Body(Entity e, float x_vel, float y_vel, bool grav, bool b, float s)
 
 	xPrimePrime = 0;
 	yPrimePrime = 0;
+	time = 0;
+	fixedX = fixedY = fixedXStep = fixedYStep = 0;
 
 	if (affectedByGravity)
 		yPrimePrime = g;
@@ -27,23 +52,125 @@ Body::Body(Entity e, float x_vel, float y_vel, bool grav, bool b, float s)
 
 void Body::move(int reverseArg) // This is essentially the game's physics engine, which updates physics-law-adhering objects according to the differential formulas dx/dt = x', dy/dt = y', dx'/dt = x", and dy'/dt = y".
 {
-	float dt = 0.01; // Equal to the tick rate
+	if (sleepState.asleep)
+		return;
+	if (fixedPoint) {
+		fixedMove(reverseArg);
+		return;
+	}
+	if (integrator != SEMI_IMPLICIT_EULER) {
+		step(reverseArg >= 0 ? dt : -dt, integrator);
+		return;
+	}
+
 	if (reverseArg >= 0)
 	{
 		xPrime += xPrimePrime * dt;
 		yPrime += yPrimePrime * dt;
 		x += xPrime * dt; 
 		y += yPrime * dt; 
+		time += dt;
 	} else { // if reverseArg = -1, so that move(-1) inverts move().
 		y += -1 * yPrime * dt;
 		x += -1 * xPrime * dt;
 		yPrime -= yPrimePrime * dt;
 		xPrime -= xPrimePrime * dt;
+		time -= dt;
 	} // move(-1) should be called upon collision with a solid hitbox.
 
 	
 }
 
+Body::FixedState Body::fixedState() const
+{
+	using namespace fixedpoint;
+	FixedState s = {fixedX, fixedY, fixedXStep, fixedYStep, fromFloat(xPrimePrime * dt * dt), fromFloat(yPrimePrime * dt * dt)};
+	if (x != toFloat(fixedX) || y != toFloat(fixedY) || xPrime != toFloat(fixedXStep) / dt || yPrime != toFloat(fixedYStep) / dt)
+		s = {fromFloat(x), fromFloat(y), fromFloat(xPrime * dt), fromFloat(yPrime * dt), s.xStepStep, s.yStepStep};
+	return s;
+} // The rest of the game only ever sees the float state, so a bounce, a collision or a setter shows up here as a float that no longer matches the fixed-point one.
+
+void Body::setFixedState(const FixedState& s)
+{
+	using namespace fixedpoint;
+	fixedX = s.x;
+	fixedY = s.y;
+	fixedXStep = s.xStep;
+	fixedYStep = s.yStep;
+	x = toFloat(s.x);
+	y = toFloat(s.y);
+	xPrime = toFloat(s.xStep) / dt;
+	yPrime = toFloat(s.yStep) / dt;
+}
+
+void Body::fixedMove(int reverseArg)
+{
+	FixedState s = fixedState();
+	if (reverseArg >= 0) {
+		s.xStep += s.xStepStep;
+		s.yStep += s.yStepStep;
+		s.x += s.xStep;
+		s.y += s.yStep;
+		time += dt;
+	} else {
+		s.y -= s.yStep;
+		s.x -= s.xStep;
+		s.yStep -= s.yStepStep;
+		s.xStep -= s.xStepStep;
+		time -= dt;
+	} // Integer additions undo exactly, so unlike the float step, move(-1) always lands back where the body started.
+	setFixedState(s);
+}
+
+static void verlet(float& position, float& velocity, float acceleration, float h)
+{
+	position += velocity * h + 0.5f * acceleration * h * h;
+	velocity += acceleration * h;
+} // Exact for constant acceleration, which is all the game has, so it matches the closed-form path at any step size up to rounding.
+
+static void rk4(float& position, float& velocity, float acceleration, float h)
+{
+	float k1x = velocity, k1v = acceleration;
+	float k2x = velocity + 0.5f * h * k1v, k2v = acceleration;
+	float k3x = velocity + 0.5f * h * k2v, k3v = acceleration;
+	float k4x = velocity + h * k3v, k4v = acceleration;
+	position += h / 6 * (k1x + 2*k2x + 2*k3x + k4x);
+	velocity += h / 6 * (k1v + 2*k2v + 2*k3v + k4v);
+} // Classic fourth-order Runge-Kutta on (x, x'). Also exact for constant acceleration, at twice the cost of Verlet, but it stays fourth order if acceleration ever comes to depend on position or velocity.
+
+void Body::step(float h, Integrator method)
+{
+	switch(method)
+	{
+		case SEMI_IMPLICIT_EULER:
+			xPrime += xPrimePrime * h;
+			yPrime += yPrimePrime * h;
+			x += xPrime * h;
+			y += yPrime * h;
+			break;
+		case VELOCITY_VERLET:
+			verlet(x, xPrime, xPrimePrime, h);
+			verlet(y, yPrime, yPrimePrime, h);
+			break;
+		case RK4:
+			rk4(x, xPrime, xPrimePrime, h);
+			rk4(y, yPrime, yPrimePrime, h);
+			break;
+	}
+	time += h;
+}
+
+void Body::setTimestep(float timestep, Integrator method)
+{
+	dt = timestep;
+	integrator = method;
+} // Semi-implicit Euler drifts from the true path by about a*dt*t/2, so larger steps should use Verlet or RK4.
+
+void Body::setFixedPoint(bool on)
+{
+	fixedPoint = on;
+}
+
 void Body::stopX() // Stops all movement in the x direction by zeroing velocity and acceleration. Should be called upon hitting a wall.
 {
 	xPrime = 0;
@@ -64,48 +191,53 @@ void Body::stop()
 
 void Body::jump(int strength)
 {
+	wake();
 	yPrime = -1 * strength;
 	yPrimePrime = g;
 } // jump(0) makes the object start falling from rest.
 
 void Body::setXPrime(float amount)
 {
+	wake();
 	xPrime = amount;
 }
 
 void Body::setYPrime(float amount)
 {
+	wake();
 	yPrime = amount;
 }
 
-float Body::getXPrime()
+float Body::getXPrime() const
 {
 	return xPrime;
 }
 
-float Body::getYPrime()
+float Body::getYPrime() const
 {
 	return yPrime;
 }
 
-float Body::getXPrimePrime()
+float Body::getXPrimePrime() const
 {
 	return xPrimePrime;
 }
 
-float Body::getYPrimePrime()
+float Body::getYPrimePrime() const
 {
 	return yPrimePrime;
 }
 
 void Body::addVelVector(float direction, float magnitude)
 {
+	wake();
 	xPrime += magnitude * cos(direction);
 	yPrime += magnitude * sin(direction);
 }
 
 void Body::addAccelVector(float direction, float magnitude)
 {
+	wake();
 	xPrimePrime += magnitude * cos(direction);
 	yPrimePrime += magnitude * sin(direction);
 }
@@ -161,7 +293,7 @@ void Body::bounce(bool velDecay)
 	bounceY(velDecay);
 }
 
-bool Body::isBouncy()
+bool Body::isBouncy() const
 {
 	return bouncy;
 }
@@ -169,4 +301,133 @@ bool Body::isBouncy()
 void Body::setBouncy()
 {
 	bouncy = true;
+}
+
+void Body::sleep()
+{
+	sleepState.asleep = (xPrime == 0 && yPrime == 0 && xPrimePrime == 0 && yPrimePrime == 0);
+}
+
+bool Body::isAsleep() const
+{
+	return sleepState.asleep;
+}
+
+void Body::wake()
+{
+	if (sleepState.asleep) {
+		sleepState.asleep = false;
+		sleepEpoch++;
+	}
+}
+
+double Body::getTime() const
+{
+	return time;
+}
+
+Body::State Body::stateAt(double t) const
+{
+	double h = t - time;
+	return {float(x + xPrime * h + 0.5 * xPrimePrime * h * h), float(y + yPrime * h + 0.5 * yPrimePrime * h * h), float(xPrime + xPrimePrime * h), float(yPrime + yPrimePrime * h)};
+} // The closed-form solution of the same equations that move() steps through, worked out in double precision.
+
+void Body::advanceTo(double t)
+{
+	State s = stateAt(t);
+	x = s.x;
+	y = s.y;
+	xPrime = s.xPrime;
+	yPrime = s.yPrime;
+	time = t;
+}
+
+static double crossing(double p, double v, double a, double bound, int direction)
+{
+	if ((direction < 0 && p <= bound && (v < 0 || (v == 0 && a < 0))) || (direction > 0 && p >= bound && (v > 0 || (v == 0 && a > 0))))
+		return 0; // Already past the edge and heading further out, or about to, so ifOnEdgeBounce() would bounce it straight away.
+
+	double turn = (a != 0) ? -v / a : -1;
+	if (turn > 0 && (direction < 0 ? a < 0 : a > 0)) {
+		double turnPosition = p + v*turn + 0.5*a*turn*turn;
+		if (direction < 0 ? turnPosition < bound : turnPosition > bound)
+			return turn;
+	} // Past the edge and heading back in, but turned round again before getting there.
+
+	double roots[2];
+	int count = 0;
+	if (a == 0) {
+		if (v != 0)
+			roots[count++] = (bound - p) / v;
+	} else {
+		double discriminant = v*v - 2*a*(p - bound);
+		if (discriminant >= 0) {
+			double q = -0.5 * (v + (v < 0 ? -1 : 1) * std::sqrt(discriminant)); // The numerically stable form, which avoids cancellation when one root is near 0.
+			roots[count++] = q / (0.5*a);
+			if (q != 0)
+				roots[count++] = (p - bound) / q;
+		}
+	} // Solves p + vt + at²/2 = bound.
+
+	double first = INFINITY;
+	for (int i = 0; i < count; i++) {
+		double velocity = v + a*roots[i];
+		if (roots[i] > 0 && roots[i] < first && (direction < 0 ? velocity < 0 : velocity > 0))
+			first = roots[i];
+	}
+	return first;
+} // The time until a position p, moving at v and accelerating at a, next crosses bound heading in direction.
+
+double Body::nextEdgeEvent(int* edge) const
+{
+	double right = crossing(x, xPrime, xPrimePrime, 1400 - currentFrame.w*size, 1);
+	double left = crossing(x, xPrime, xPrimePrime, 0, -1);
+	double bottom = crossing(y, yPrime, yPrimePrime, 750 - currentFrame.h*size, 1);
+	double top = crossing(y, yPrime, yPrimePrime, 0, -1);
+
+	double first = right;
+	*edge = 1;
+	if (top < first) {
+		first = top;
+		*edge = 2;
+	}
+	if (left < first) {
+		first = left;
+		*edge = 3;
+	}
+	if (bottom < first) {
+		first = bottom;
+		*edge = 4;
+	}
+	return time + first;
+} // Uses the same edges as ifOnEdgeBounce().
+
+void Body::advanceBouncing(double t, bool yVelDecay)
+{
+	for (int bounces = 0; bounces < 1000; bounces++) {
+		int edge;
+		double event = nextEdgeEvent(&edge);
+		if (event > t)
+			break;
+
+		advanceTo(event);
+		if (edge == 1 || edge == 3) {
+			xPrime *= -1;
+		} else {
+			yPrime *= -1;
+			if (yVelDecay)
+				yPrime *= 0.9;
+		}
+
+		int nextEdge;
+		if (nextEdgeEvent(&nextEdge) - time < 1e-9 && nextEdge == edge) {
+			if (edge == 1 || edge == 3)
+				stopX();
+			else
+				stopY();
+		} // Bounced with no speed left to leave the edge, so the body is resting on it, where ticking would leave it jittering in place.
+	} // Capped, in case a body somehow keeps bouncing without getting anywhere.
+
+	if (t > time)
+		advanceTo(t);
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "Contacts.hpp"
+
+Contact::Contact(char type, int index, int side, float depth)
+: type(type), index(index), side(static_cast<Side>(side)), depth(depth), phase(ENTER)
+{
+	normalX = (side == RIGHT) ? -1 : (side == LEFT) ? 1 : 0;
+	normalY = (side == BOTTOM) ? -1 : (side == TOP) ? 1 : 0;
+}
+
+bool Contact::samePair(const Contact& c) const
+{
+	return type == c.type && index == c.index;
+}
+
+bool Contact::operator<(const Contact& c) const
+{
+	return (type != c.type) ? type < c.type : index < c.index;
+}
+
+void ContactList::begin()
+{
+	now.clear();
+}
+
+void ContactList::add(const Contact& c)
+{
+	if (!has(c.type, c.index))
+		now.push_back(c);
+}
+
+bool ContactList::has(char type, int index) const
+{
+	for (const Contact& c : now) {
+		if (c.type == type && c.index == index)
+			return true;
+	}
+	return false;
+} // The player only ever touches a handful of things, so a linear search beats anything cleverer.
+
+const vector<Contact>& ContactList::finish()
+{
+	std::sort(now.begin(), now.end());
+	events.clear();
+
+	unsigned int j = 0;
+	for (Contact& c : now) {
+		while (j < before.size() && before[j] < c) {
+			events.push_back(before[j]);
+			events.back().phase = Contact::EXIT;
+			j++;
+		}
+		c.phase = (j < before.size() && before[j].samePair(c)) ? Contact::STAY : Contact::ENTER;
+		if (c.phase == Contact::STAY)
+			j++;
+		events.push_back(c);
+	}
+	for (; j < before.size(); j++) {
+		events.push_back(before[j]);
+		events.back().phase = Contact::EXIT;
+	} // Both lists are sorted, so one walk down them pairs everything up.
+
+	before.swap(now);
+	return events;
+} // An EXIT carries the pair's last contact, so handlers can still see which side it was on.
+
+void ContactList::erase(char type, int index)
+{
+	for (unsigned int i = 0; i < before.size(); i++) {
+		if (before[i].type == type && before[i].index == index) {
+			before.erase(before.begin() + i);
+			i--;
+		} else if (before[i].type == type && before[i].index > index) {
+			before[i].index--;
+		}
+	}
+} // Contacts are keyed by queue index like the spatial grids, so removals made anywhere else just show up as a pair leaving and another entering.
+
+void ContactList::clear()
+{
+	now.clear();
+	before.clear();
+	events.clear();
+}
\ No newline at end of file
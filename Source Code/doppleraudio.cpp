@@ -0,0 +1,211 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+#include "DopplerAudio.hpp"
+
+static const double PI = 3.14159265358979;
+
+DopplerAudio::DopplerAudio()
+: left(HISTORY + TAPS, 0), right(HISTORY + TAPS, 0), coefficients((PHASES + 1) * TAPS), written(0), readA(0), readB(0), tempoPosition(0), gainA(1), gainB(0), fading(0), pitch(1), tempo(1), wet(0), targetPitch(1), targetTempo(1), busyTicks(0), processedFrames(0), rate(44100), attached(false)
+{
+	for (int p = 0; p <= PHASES; p++) {
+		float* row = &coefficients[p*TAPS];
+		double sum = 0;
+		for (int k = 0; k < TAPS; k++) {
+			double x = (k - (TAPS/2 - 1)) - static_cast<double>(p)/PHASES;
+			double sinc = (x == 0) ? 1 : std::sin(PI*x)/(PI*x);
+			double window = 0.42 + 0.5*std::cos(PI*x/(TAPS/2)) + 0.08*std::cos(2*PI*x/(TAPS/2));
+			row[k] = sinc*window;
+			sum += row[k];
+		}
+		for (int k = 0; k < TAPS; k++)
+			row[k] /= sum;
+	}
+} // Row p interpolates at p/PHASES of the way from tap TAPS/2-1 to the next, under a Blackman window. Row 0 and row PHASES come out as single taps, so whole-frame positions read back exactly. The cutoff is at the original Nyquist frequency, which is enough since nothing is ever played faster than it was mixed.
+
+bool DopplerAudio::attach()
+{
+	int frequency, channels;
+	Uint16 format;
+	if (Mix_QuerySpec(&frequency, &format, &channels) == 0 || format != AUDIO_S16SYS || channels != 2) {
+		std::cout << "Relativistic audio is off. Error: it only handles 16-bit stereo." << std::endl;
+		return false;
+	}
+	rate = frequency;
+
+	if (Mix_RegisterEffect(MIX_CHANNEL_POST, effect, nullptr, this) == 0) {
+		std::cout << "Failed to register the relativistic audio effect. Error: " << Mix_GetError() << std::endl;
+		return false;
+	}
+	attached = true;
+	return true;
+}
+
+void DopplerAudio::detach()
+{
+	if (attached)
+		Mix_UnregisterEffect(MIX_CHANNEL_POST, effect);
+	attached = false;
+}
+
+void DopplerAudio::effect(int /*channel*/, void* stream, int length, void* self)
+{
+	static_cast<DopplerAudio*>(self)->process(static_cast<Sint16*>(stream), length / (2*sizeof(Sint16)));
+}
+
+void DopplerAudio::setTarget(float pitch, float tempo)
+{
+	targetPitch = std::max(0.1f, std::min(1.0f, pitch));
+	targetTempo = std::max(0.1f, std::min(1.0f, tempo));
+}
+
+void DopplerAudio::write(const Sint16* samples, int frames)
+{
+	for (int n = 0; n < frames; n++) {
+		int at = (written + n) % HISTORY;
+		left[at] = samples[2*n] * (1/32768.0f);
+		right[at] = samples[2*n + 1] * (1/32768.0f);
+		if (at < TAPS) {
+			left[HISTORY + at] = left[at];
+			right[HISTORY + at] = right[at];
+		}
+	}
+	written += frames;
+}
+
+#if !defined(__AVX__)
+static float sum(__m128 v)
+{
+	__m128 s = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+}
+#endif
+
+void DopplerAudio::read(double position, float* l, float* r) const
+{
+	long long whole = static_cast<long long>(std::floor(position));
+	float phase = static_cast<float>(position - whole) * PHASES;
+	int row = std::min(static_cast<int>(phase), PHASES - 1);
+	const float* c0 = &coefficients[row*TAPS];
+	int at = static_cast<int>(((whole - (TAPS/2 - 1)) % HISTORY + HISTORY) % HISTORY);
+
+#if defined(__AVX__)
+	__m256 lower = _mm256_loadu_ps(c0), c = _mm256_add_ps(lower, _mm256_mul_ps(_mm256_set1_ps(phase - row), _mm256_sub_ps(_mm256_loadu_ps(c0 + TAPS), lower)));
+	__m256 sl = _mm256_mul_ps(c, _mm256_loadu_ps(&left[at])), sr = _mm256_mul_ps(c, _mm256_loadu_ps(&right[at]));
+	__m128 hl = _mm_add_ps(_mm256_castps256_ps128(sl), _mm256_extractf128_ps(sl, 1)), hr = _mm_add_ps(_mm256_castps256_ps128(sr), _mm256_extractf128_ps(sr, 1));
+	__m128 lr = _mm_add_ps(_mm_unpacklo_ps(hl, hr), _mm_unpackhi_ps(hl, hr)); // l0+l2, r0+r2, l1+l3, r1+r3
+	lr = _mm_add_ps(lr, _mm_movehl_ps(lr, lr));
+	*l = _mm_cvtss_f32(lr);
+	*r = _mm_cvtss_f32(_mm_shuffle_ps(lr, lr, 1));
+#else
+	__m128 t = _mm_set1_ps(phase - row);
+	__m128 lowerA = _mm_loadu_ps(c0), lowerB = _mm_loadu_ps(c0 + 4);
+	__m128 cA = _mm_add_ps(lowerA, _mm_mul_ps(t, _mm_sub_ps(_mm_loadu_ps(c0 + TAPS), lowerA)));
+	__m128 cB = _mm_add_ps(lowerB, _mm_mul_ps(t, _mm_sub_ps(_mm_loadu_ps(c0 + TAPS + 4), lowerB)));
+	*l = sum(_mm_add_ps(_mm_mul_ps(cA, _mm_loadu_ps(&left[at])), _mm_mul_ps(cB, _mm_loadu_ps(&left[at + 4]))));
+	*r = sum(_mm_add_ps(_mm_mul_ps(cA, _mm_loadu_ps(&right[at])), _mm_mul_ps(cB, _mm_loadu_ps(&right[at + 4]))));
+#endif
+} // The two rows either side of the position are blended, which does as well as a table 64 times the size.
+
+void DopplerAudio::process(Sint16* samples, int frames)
+{
+	Uint64 begin = SDL_GetPerformanceCounter();
+	float goalPitch = targetPitch, goalTempo = targetTempo, blend = wet.load(std::memory_order_relaxed);
+	long long start = written;
+	write(samples, frames);
+
+	bool shifting = goalPitch != 1 || goalTempo != 1 || pitch != 1 || tempo != 1;
+	if (!shifting && blend == 0) {
+		busyTicks += SDL_GetPerformanceCounter() - begin;
+		processedFrames += frames;
+		return;
+	} // Passed straight through.
+
+	if (blend == 0) {
+		readA = tempoPosition = start - TAPS/2;
+		gainA = 1;
+		fading = 0;
+	} // Starts from where the mix is now, as far back as the filter needs to see ahead.
+
+	const float slew = 1.0f/RAMP, step = 1.0f/FADE;
+	for (int n = 0; n < frames; n++) {
+		long long now = start + n;
+		pitch += std::max(-slew, std::min(slew, goalPitch - pitch));
+		tempo += std::max(-slew, std::min(slew, goalTempo - tempo));
+		bool settled = goalPitch == 1 && goalTempo == 1 && pitch == 1 && tempo == 1;
+		double live = now - TAPS/2; // The newest position the filter can read without running past now.
+
+		float l, r, bl, br;
+		read(readA, &l, &r);
+		l *= gainA;
+		r *= gainA;
+		if (fading > 0) {
+			read(readB, &bl, &br);
+			l += gainB*bl;
+			r += gainB*br;
+		}
+
+		if (settled && fading == 0 && readA >= live - 1)
+			blend = std::max(0.0f, blend - step);
+		else
+			blend = std::min(1.0f, blend + step); // Only lets go once the read head is back with the mix.
+
+		for (int channel = 0; channel < 2; channel++) {
+			float dry = samples[2*n + channel] * (1/32768.0f), shifted = channel ? r : l;
+			float out = (dry + blend*(shifted - dry)) * 32768.0f;
+			samples[2*n + channel] = static_cast<Sint16>(std::max(-32768.0f, std::min(32767.0f, out)));
+		}
+
+		readA = std::min(readA + pitch, live + 1);
+		tempoPosition = std::min(tempoPosition + tempo, live + 1);
+		if (fading > 0) {
+			readB = std::min(readB + pitch, live + 1);
+			fading--;
+			gainB = 1 - static_cast<float>(fading)/FADE;
+			gainA = 1 - gainB;
+			if (fading == 0) {
+				readA = readB;
+				gainA = 1;
+				gainB = 0;
+			}
+		} else if (settled ? readA < live : (live - tempoPosition > HISTORY - 2*GRAIN)) {
+			readB = tempoPosition = live + 1;
+			fading = FADE;
+		} else if (std::abs(readA - tempoPosition) > GRAIN) {
+			readB = tempoPosition;
+			fading = FADE;
+		}
+	} // Once relativity is off and the ramps are done, or once the mix has got as far ahead as the history goes, the read head skips back to the mix rather than racing to catch up.
+	wet.store(blend, std::memory_order_relaxed); // Kept in a local while the buffer is worked through, so bypassed() only sees it between buffers.
+
+	busyTicks += SDL_GetPerformanceCounter() - begin;
+	processedFrames += frames;
+}
+
+double DopplerAudio::load() const
+{
+	long long frames = processedFrames;
+	return frames ? (static_cast<double>(busyTicks) / SDL_GetPerformanceFrequency()) / (static_cast<double>(frames) / rate) : 0;
+}
+
+void DopplerAudio::resetLoad()
+{
+	busyTicks = 0;
+	processedFrames = 0;
+}
+
+bool DopplerAudio::bypassed() const
+{
+	return wet == 0;
+}
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <iostream>
+#include <vector>
 
 #include "Entity.hpp"
+#include "Fixed.hpp"
 #include "Body.hpp"
+#include "Path.hpp"
 #include "Surface.hpp"
 
 
@@ -18,12 +21,12 @@ Entity::Entity(float xCoord, float yCoord, int width, int height, SDL_Texture* t
 	vanished = false;
 }
 
-float Entity::getX()
+float Entity::getX() const
 {
 	return x;
 }
 
-float Entity::getY()
+float Entity::getY() const
 {
 	return y;
 }
@@ -64,17 +67,17 @@ void Entity::setFrameY(float amount)
 	currentFrame.y = amount;
 }
 
-int Entity::getWidth()
+int Entity::getWidth() const
 {
 	return currentFrame.w;
 }
 
-int Entity::getHeight()
+int Entity::getHeight() const
 {
 	return currentFrame.h;
 }
 
-SDL_Rect Entity::getFrame()
+SDL_Rect Entity::getFrame() const
 {
 	return currentFrame;
 }
@@ -89,7 +92,7 @@ void Entity::setHeight(int amount)
 	currentFrame.h = amount;
 }
 
-std::pair<float,float> Entity::centerOf()
+std::pair<float,float> Entity::centerOf() const
 {
 	float actualWidth = currentFrame.w * size;
 	float actualHeight = currentFrame.h * size;
@@ -99,7 +102,7 @@ std::pair<float,float> Entity::centerOf()
 	return coords;
 }
 
-float Entity::getSize()
+float Entity::getSize() const
 {
 	return size;
 }
@@ -109,7 +112,7 @@ void Entity::setSize(float s)
 	size = s;
 }
 
-SDL_Texture* Entity::getTexture()
+SDL_Texture* Entity::getTexture() const
 {
 	return texture;
 }
@@ -130,7 +133,7 @@ void Entity::setTilt(double degrees)
 	tilt = degrees;
 }
 
-double Entity::getTilt()
+double Entity::getTilt() const
 {
 	return tilt;
 }
@@ -193,12 +196,22 @@ void Entity::toggleVanished()
 	}
 }
 
-bool Entity::isVanished()
+bool Entity::isVanished() const
 {
 	return vanished;
 }
 
-bool Entity::isPlatform()
+int Entity::getInstanceId() const
+{
+	return instanceId;
+}
+
+void Entity::setInstanceId(int id)
+{
+	instanceId = id;
+}
+
+bool Entity::isPlatform() const
 {
 	return hitboxAdjust;
 }
@@ -218,22 +231,22 @@ void Entity::setYPrime(float amount)
 	;
 }
 
-bool Entity::operator==(Entity e)
+bool Entity::operator==(const Entity& e) const
 {
 	return(sourceTexture == e.getTexture() || texture == e.getTexture());
 }
 
-bool Entity::operator==(SDL_Texture* t)
+bool Entity::operator==(SDL_Texture* t) const
 {
 	return(texture == t);
 }
 
-bool Entity::operator!=(Entity e)
+bool Entity::operator!=(const Entity& e) const
 {
 	return !(*this == e);
 }
 
-bool Entity::operator!=(SDL_Texture* t)
+bool Entity::operator!=(SDL_Texture* t) const
 {
 	return !(*this == t);
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <cmath>
+
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "EventScheduler.hpp"
+
+bool EventScheduler::Occurrence::operator>(const Occurrence& o) const
+{
+	return (time != o.time) ? time > o.time : event > o.event;
+} // Ties go to the event added first, so simultaneous events always come out in the same order.
+
+int EventScheduler::add(const SpacetimeEvent& e)
+{
+	events.push_back(e);
+	return events.size() - 1;
+}
+
+void EventScheduler::clear()
+{
+	events.clear();
+	queue = {};
+}
+
+double EventScheduler::timeOf(int event, long long count) const
+{
+	const SpacetimeEvent& e = events[event];
+	return gamma * (e.t + count*e.period - beta * e.x / lightSpeed);
+}
+
+double EventScheduler::cycles(int event, double now) const
+{
+	const SpacetimeEvent& e = events[event];
+	return (now/gamma - e.t + beta * e.x / lightSpeed) / e.period;
+} // timeOf() solved for count.
+
+void EventScheduler::setFrame(double beta, double gamma, double lightSpeed, double now)
+{
+	this->beta = beta;
+	this->gamma = gamma;
+	this->lightSpeed = lightSpeed;
+
+	queue = {};
+	for (unsigned int i = 0; i < events.size(); i++) {
+		long long count = 0;
+		if (events[i].period > 0)
+			count = std::max(0LL, static_cast<long long>(std::floor(cycles(i, now))) + 1);
+		else if (timeOf(i, 0) <= now)
+			continue; // One-offs that have already happened are gone.
+		queue.push({timeOf(i, count), static_cast<int>(i), count});
+	}
+}
+
+bool EventScheduler::pop(double now, Due* due)
+{
+	if (queue.empty() || queue.top().time > now)
+		return false;
+
+	Occurrence o = queue.top();
+	queue.pop();
+	if (events[o.event].period > 0)
+		queue.push({timeOf(o.event, o.count + 1), o.event, o.count + 1});
+
+	*due = {o.event, events[o.event].kind, events[o.event].target, o.time};
+	return true;
+}
+
+bool EventScheduler::last(int event, double now, double* time) const
+{
+	long long count = 0;
+	if (events[event].period > 0)
+		count = static_cast<long long>(std::floor(cycles(event, now)));
+	if (count < 0 || timeOf(event, count) > now)
+		return false;
+
+	*time = timeOf(event, count);
+	return true;
+}
+
+const SpacetimeEvent& EventScheduler::event(int event) const
+{
+	return events[event];
+}
+
+int EventScheduler::size() const
+{
+	return events.size();
+}
\ No newline at end of file
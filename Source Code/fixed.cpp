@@ -0,0 +1,34 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <cmath>
+#include <climits>
+
+#include "Fixed.hpp"
+
+Fixed fixedpoint::fromFloat(float f)
+{
+	double scaled = static_cast<double>(f) * ONE;
+	if (scaled >= INT_MAX)
+		return INT_MAX;
+	if (scaled <= INT_MIN)
+		return INT_MIN;
+	return static_cast<Fixed>(scaled + (scaled >= 0 ? 0.5 : -0.5));
+} // Scaling by a power of two in double precision is exact, so the only rounding is the one to the nearest step, with halves rounded away from zero. Truncating the sum is a single instruction, where std::round() is often a library call.
+
+float fixedpoint::toFloat(Fixed f)
+{
+	return static_cast<float>(static_cast<double>(f) / ONE);
+} // The division is exact in double, leaving a single rounding to float.
+
+Fixed fixedpoint::multiply(Fixed a, Fixed b)
+{
+	Sint64 product = static_cast<Sint64>(a) * b + (ONE / 2);
+	return static_cast<Fixed>(product >> FRACTION_BITS);
+}
+
+Fixed fixedpoint::divide(Fixed a, Fixed b)
+{
+	return static_cast<Fixed>(static_cast<Sint64>(a) * ONE / b);
+}
\ No newline at end of file
@@ -6,12 +6,16 @@
 #include <map>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 #include <cassert>
+#include <climits>
 #include <Windows.h>
 
 #include "RenderWindow.hpp"
 #include "Entity.hpp"
+#include "Fixed.hpp"
 #include "Body.hpp"
+#include "Path.hpp"
 #include "Surface.hpp"
 #include "GameFuncs.hpp"
 
@@ -62,12 +66,14 @@ void gamefuncs::debug(string m)
 void gamefuncs::displayEntity(vector<Surface>* queue, vector<float>* sizeQueue, vector<char>* animQueue, Surface s, float size, char animCode) 
 {
 	queue->push_back(s);
+	queue->back().sleep();
 	sizeQueue->push_back(size);
 	animQueue->push_back(animCode);
 }
 void gamefuncs::displayEntity(vector<Body>* queue, vector<float>* sizeQueue, vector<bool>* hitboxQueue, Body b, float size, bool hitbox) 
 {
 	queue->push_back(b);
+	queue->back().sleep();
 	sizeQueue->push_back(size);
 	hitboxQueue->push_back(hitbox);
 }
@@ -75,7 +81,7 @@ void gamefuncs::displayEntity(vector<Entity>* queue, vector<float>* sizeQueue, E
 {
 	queue->push_back(e);
 	sizeQueue->push_back(size);
-} // Displays an entity by adding it to the render queue.
+} // Displays an entity by adding it to the render queue. Bodies and surfaces that aren't moving go in asleep, which covers the invisible floor, walls and ceiling.
 
 void gamefuncs::removeEntity(vector<Surface>* queue, vector<float>* sizeQueue, vector<char>* animQueue, Entity sprite)
 {
@@ -110,6 +116,58 @@ void gamefuncs::removeEntity(vector<Entity>* queue, vector<float>* sizeQueue, En
 	}
 } // Deletes an entity by removing it from the render queue. Pass the Entity to be removed.
 
+int gamefuncs::findInstance(const vector<Surface>* queue, int id)
+{
+	for (unsigned int i = 0; i < queue->size(); i++) {
+		if (queue->at(i).getInstanceId() == id)
+			return i;
+	}
+	return -1;
+}
+int gamefuncs::findInstance(const vector<Body>* queue, int id)
+{
+	for (unsigned int i = 0; i < queue->size(); i++) {
+		if (queue->at(i).getInstanceId() == id)
+			return i;
+	}
+	return -1;
+}
+int gamefuncs::findInstance(const vector<Entity>* queue, int id)
+{
+	for (unsigned int i = 0; i < queue->size(); i++) {
+		if (queue->at(i).getInstanceId() == id)
+			return i;
+	}
+	return -1;
+} // Returns the index of the entity created from the level element with the given id, or -1 if it isn't in the queue.
+
+void gamefuncs::removeInstance(vector<Surface>* queue, vector<float>* sizeQueue, vector<char>* animQueue, int id)
+{
+	int i = findInstance(queue, id);
+	if (i >= 0) {
+		queue->erase(queue->begin() + i);
+		sizeQueue->erase(sizeQueue->begin() + i);
+		animQueue->erase(animQueue->begin() + i);
+	}
+}
+void gamefuncs::removeInstance(vector<Body>* queue, vector<float>* sizeQueue, vector<bool>* hitboxQueue, int id)
+{
+	int i = findInstance(queue, id);
+	if (i >= 0) {
+		queue->erase(queue->begin() + i);
+		sizeQueue->erase(sizeQueue->begin() + i);
+		hitboxQueue->erase(hitboxQueue->begin() + i);
+	}
+}
+void gamefuncs::removeInstance(vector<Entity>* queue, vector<float>* sizeQueue, int id)
+{
+	int i = findInstance(queue, id);
+	if (i >= 0) {
+		queue->erase(queue->begin() + i);
+		sizeQueue->erase(sizeQueue->begin() + i);
+	}
+} // Like removeEntity, but matches on instance id rather than texture, since several elements usually share a prototype.
+
 void gamefuncs::clearEntities(vector<Surface>* queue, vector<float>* sizeQueue, vector<char>* animQueue) 
 {
 	queue->clear();
@@ -174,9 +232,11 @@ int gamefuncs::collisionDetected(SDL_Rect a, SDL_Rect b)
  	}
 } // This function is not commutative, so think of a as the moving object and b as the object it collides with. The returned int indicates which side of a has collided.
 
+const float PLATFORM_EPSILON = 17.5; // How far below the top of a platform's sprite its collision starts, so the player stands on the platform's surface rather than its back edge.
+
 int gamefuncs::collided(Entity e, Entity f, float eContraction, float fContraction)
 {
-	float epsilon = 17.5;
+	float epsilon = PLATFORM_EPSILON;
 	//float eta = 7.5;
 
 	SDL_Rect eRect;
@@ -203,6 +263,157 @@ int gamefuncs::collided(Entity e, Entity f, float eContraction, float fContracti
 	return collisionDetected(eRect, fRect);
 } // Uses collisionDetected() when passed two Entities.
 
+static SDL_FRect collisionRect(const Entity& e, float contraction)
+{
+	SDL_FRect r = {e.getX(), e.getY(), e.getWidth() * e.getSize() * contraction, e.getHeight() * e.getSize()};
+	if (e.isPlatform()) {
+		r.y += PLATFORM_EPSILON;
+		r.h -= PLATFORM_EPSILON;
+	}
+	return r;
+} // The same rect that collided() tests, but without rounding to whole pixels.
+
+struct FixedRect
+{
+	Sint64 x, y, w, h; // Q16.16, widened so that sums and scaled differences can't overflow.
+};
+
+static FixedRect fixedCollisionRect(const Entity& e, float contraction)
+{
+	using namespace fixedpoint;
+	FixedRect r = {fromFloat(e.getX()), fromFloat(e.getY()), multiply(multiply(fromFloat(e.getWidth()), fromFloat(e.getSize())), fromFloat(contraction)), multiply(fromFloat(e.getHeight()), fromFloat(e.getSize()))};
+	if (e.isPlatform()) {
+		r.y += fromFloat(PLATFORM_EPSILON);
+		r.h -= fromFloat(PLATFORM_EPSILON);
+	}
+	return r;
+} // collisionRect() in fixed point. Each input is rounded on its own, so no multiply-add is left for the compiler to fuse.
+
+static Sint64 fixedFraction(Sint64 distance, Sint64 step)
+{
+	Sint64 scaled = distance * fixedpoint::ONE;
+	Sint64 q = scaled / step;
+	if (scaled % step != 0 && ((scaled < 0) != (step < 0)))
+		q--;
+	return q;
+} // distance/step in Q16.16, rounded down like the float division's sign would suggest, so a body just short of touching never reads as already overlapping.
+
+static float fixedSweptCollision(const Entity& e, float dx, float dy, const Entity& f, int* side, float eContraction, float fContraction)
+{
+	FixedRect a = fixedCollisionRect(e, eContraction);
+	FixedRect b = fixedCollisionRect(f, fContraction);
+	Sint64 stepX = fixedpoint::fromFloat(dx), stepY = fixedpoint::fromFloat(dy);
+	Sint64 xEntry, xExit, yEntry, yExit;
+
+	if (stepX > 0) {
+		xEntry = fixedFraction(b.x - (a.x + a.w), stepX);
+		xExit = fixedFraction(b.x + b.w - a.x, stepX);
+	} else if (stepX < 0) {
+		xEntry = fixedFraction(b.x + b.w - a.x, stepX);
+		xExit = fixedFraction(b.x - (a.x + a.w), stepX);
+	} else if (a.x < b.x + b.w && b.x < a.x + a.w) {
+		xEntry = LLONG_MIN;
+		xExit = LLONG_MAX;
+	} else {
+		return 1;
+	}
+
+	if (stepY > 0) {
+		yEntry = fixedFraction(b.y - (a.y + a.h), stepY);
+		yExit = fixedFraction(b.y + b.h - a.y, stepY);
+	} else if (stepY < 0) {
+		yEntry = fixedFraction(b.y + b.h - a.y, stepY);
+		yExit = fixedFraction(b.y - (a.y + a.h), stepY);
+	} else if (a.y < b.y + b.h && b.y < a.y + a.h) {
+		yEntry = LLONG_MIN;
+		yExit = LLONG_MAX;
+	} else {
+		return 1;
+	}
+
+	Sint64 entry = std::max(xEntry, yEntry), exit = std::min(xExit, yExit);
+	if (entry >= exit || entry < 0 || entry >= fixedpoint::ONE)
+		return 1;
+
+	if (xEntry > yEntry)
+		*side = (stepX > 0) ? 1 : 3;
+	else
+		*side = (stepY > 0) ? 4 : 2;
+	return fixedpoint::toFloat(entry);
+} // sweptCollision() in integer arithmetic, for the fixed-point physics mode. The fraction it returns is a multiple of 1/65536, which converts to float exactly.
+
+float gamefuncs::sweptCollision(const Entity& e, float dx, float dy, const Entity& f, int* side, float eContraction, float fContraction)
+{
+	if (Body::fixedPoint)
+		return fixedSweptCollision(e, dx, dy, f, side, eContraction, fContraction);
+
+	SDL_FRect a = collisionRect(e, eContraction);
+	SDL_FRect b = collisionRect(f, fContraction);
+	float xEntry, xExit, yEntry, yExit;
+
+	if (dx > 0) {
+		xEntry = (b.x - (a.x + a.w)) / dx;
+		xExit = (b.x + b.w - a.x) / dx;
+	} else if (dx < 0) {
+		xEntry = (b.x + b.w - a.x) / dx;
+		xExit = (b.x - (a.x + a.w)) / dx;
+	} else if (a.x < b.x + b.w && b.x < a.x + a.w) {
+		xEntry = -INFINITY;
+		xExit = INFINITY;
+	} else {
+		return 1;
+	}
+
+	if (dy > 0) {
+		yEntry = (b.y - (a.y + a.h)) / dy;
+		yExit = (b.y + b.h - a.y) / dy;
+	} else if (dy < 0) {
+		yEntry = (b.y + b.h - a.y) / dy;
+		yExit = (b.y - (a.y + a.h)) / dy;
+	} else if (a.y < b.y + b.h && b.y < a.y + a.h) {
+		yEntry = -INFINITY;
+		yExit = INFINITY;
+	} else {
+		return 1;
+	} // The times, as fractions of the step, at which e starts and stops overlapping f along each axis.
+
+	float entry = std::max(xEntry, yEntry), exit = std::min(xExit, yExit);
+	if (entry >= exit || entry < 0 || entry >= 1)
+		return 1; // Missed, already overlapping (which collided() handles), or not reached within this step.
+
+	if (xEntry > yEntry)
+		*side = (dx > 0) ? 1 : 3;
+	else
+		*side = (dy > 0) ? 4 : 2;
+	return entry;
+} // Returns the fraction of the step (dx,dy) at which e first touches f, or 1 if it doesn't, and sets side the same way collisionDetected() would. f is treated as stationary.
+
+float gamefuncs::penetration(const Entity& e, const Entity& f, int side, float eContraction, float fContraction)
+{
+	if (Body::fixedPoint) {
+		FixedRect a = fixedCollisionRect(e, eContraction);
+		FixedRect b = fixedCollisionRect(f, fContraction);
+		Sint64 depth[5] = {0, a.x + a.w - b.x, b.y + b.h - a.y, b.x + b.w - a.x, a.y + a.h - b.y};
+		return (side >= 1 && side <= 4) ? fixedpoint::toFloat(static_cast<Fixed>(depth[side])) : 0;
+	}
+
+	SDL_FRect a = collisionRect(e, eContraction);
+	SDL_FRect b = collisionRect(f, fContraction);
+
+	switch (side)
+	{
+		case 1:
+			return a.x + a.w - b.x;
+		case 2:
+			return b.y + b.h - a.y;
+		case 3:
+			return b.x + b.w - a.x;
+		case 4:
+			return a.y + a.h - b.y;
+	}
+	return 0;
+} // How far e has to move back out of f through the given side to stop overlapping it.
+
 bool gamefuncs::sdlCollided(Entity e, Entity f) 
 {
 	SDL_Rect eRect;
@@ -230,9 +441,10 @@ float gamefuncs::distance(float x1, float x2, float y1, float y2)
 	return sqrt((x1 - x2)*(x1 - x2) + (y1 - y2)*(y1 - y2));
 } // Returns the Euclidean Distance between (x1,x2) and (y1,y2).
 
-float gamefuncs::entityDistance(Entity e, Entity f) 
+float gamefuncs::entityDistance(const Entity& e, const Entity& f) 
 {
-	return distance(e.centerOf().first, f.centerOf().first, e.centerOf().second, f.centerOf().second);
+	pair<float,float> c = e.centerOf(), d = f.centerOf();
+	return distance(c.first, d.first, c.second, d.second);
 }
 
 void gamefuncs::setColour(Entity e, Uint8 r, Uint8 g, Uint8 b)
@@ -283,16 +495,6 @@ bool gamefuncs::mouseOver(Entity e, int mX, int mY)
 	return SDL_HasIntersection(&eRect, &mouse);
 }
 
-void gamefuncs::playSound(string soundKey, map<string, Mix_Chunk*>& soundMap, int r) 
-{
-	Mix_PlayChannel(-1, soundMap[soundKey], r);
-} // Plays a sound effect and repeats it r times.
-
-void gamefuncs::stopSound()
-{
-	Mix_HaltChannel(-1);
-}
-
 void gamefuncs::startMusic(string musicKey, map<string, Mix_Music*>& musicMap) 
 {
 	if (!Mix_PlayingMusic())
@@ -0,0 +1,121 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "JobSystem.hpp"
+
+JobSystem::JobSystem(int threadCount)
+: current(nullptr), remaining(0), batch(0), stopping(false)
+{
+	if (threadCount <= 0)
+		threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	for (int i = 0; i < threadCount; i++)
+		workers.emplace_back(new Worker);
+	for (int i = 1; i < threadCount; i++)
+		threads.emplace_back(&JobSystem::work, this, i);
+} // The calling thread is worker 0, so threadCount threads share the work but only threadCount-1 are started.
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> hold(wakeLock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& t : threads)
+		t.join();
+}
+
+int JobSystem::chunkCount(int count, int grain)
+{
+	return (count <= 0) ? 0 : (count + std::max(grain, 1) - 1) / std::max(grain, 1);
+}
+
+int JobSystem::threadCount() const
+{
+	return workers.size();
+}
+
+void JobSystem::parallelFor(int count, int grain, const Job& job)
+{
+	grain = std::max(grain, 1);
+	int chunks = chunkCount(count, grain);
+	if (threads.empty() || chunks <= 1) {
+		for (int k = 0; k < chunks; k++)
+			job(k*grain, std::min(count, (k+1)*grain), k);
+		return;
+	} // Not worth waking anyone for.
+
+	current = &job;
+	remaining = chunks;
+	int n = workers.size();
+	for (int w = 0; w < n; w++) {
+		std::lock_guard<std::mutex> hold(workers[w]->lock);
+		for (int k = chunks*w/n; k < chunks*(w+1)/n; k++)
+			workers[w]->chunks.push_back({k*grain, std::min(count, (k+1)*grain), k});
+	} // Each thread starts with a contiguous run of chunks, so neighbouring bodies stay on one core unless they're stolen.
+
+	{
+		std::lock_guard<std::mutex> hold(wakeLock);
+		batch++;
+	}
+	wake.notify_all();
+
+	while (remaining > 0) {
+		if (!runOne(0))
+			std::this_thread::yield();
+	} // The caller works through its own chunks and then steals, rather than sitting idle.
+	current = nullptr;
+}
+
+void JobSystem::work(int self)
+{
+	unsigned int seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> hold(wakeLock);
+			wake.wait(hold, [&]{ return stopping || batch != seen; });
+			if (stopping)
+				return;
+			seen = batch;
+		}
+		while (runOne(self));
+	}
+}
+
+bool JobSystem::runOne(int self)
+{
+	Chunk c;
+	bool found = false;
+	int n = workers.size();
+
+	{
+		Worker& own = *workers[self];
+		std::lock_guard<std::mutex> hold(own.lock);
+		if (!own.chunks.empty()) {
+			c = own.chunks.back();
+			own.chunks.pop_back();
+			found = true;
+		}
+	}
+	for (int i = 1; i < n && !found; i++) {
+		Worker& victim = *workers[(self + i) % n];
+		std::lock_guard<std::mutex> hold(victim.lock);
+		if (!victim.chunks.empty()) {
+			c = victim.chunks.front();
+			victim.chunks.pop_front();
+			found = true;
+		}
+	} // Steals the chunk its owner would have reached last.
+
+	if (!found)
+		return false;
+	(*current)(c.begin, c.end, c.index);
+	remaining--;
+	return true;
+}
\ No newline at end of file
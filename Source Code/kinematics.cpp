@@ -0,0 +1,403 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KINEMATICS_SSE
+#endif // MSVC doesn't define __SSE2__, but every x64 target has it.
+
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "JobSystem.hpp"
+#include "Kinematics.hpp"
+
+using std::vector;
+
+static void integrate(float* position, float* velocity, const float* acceleration, int count, float dt)
+{
+	int i = 0;
+#if defined(__AVX__)
+	__m256 step = _mm256_set1_ps(dt);
+	for (; i + 8 <= count; i += 8) {
+		__m256 v = _mm256_add_ps(_mm256_loadu_ps(velocity + i), _mm256_mul_ps(_mm256_loadu_ps(acceleration + i), step));
+		_mm256_storeu_ps(velocity + i, v);
+		_mm256_storeu_ps(position + i, _mm256_add_ps(_mm256_loadu_ps(position + i), _mm256_mul_ps(v, step)));
+	}
+#elif defined(KINEMATICS_SSE)
+	__m128 step = _mm_set1_ps(dt);
+	for (; i + 4 <= count; i += 4) {
+		__m128 v = _mm_add_ps(_mm_loadu_ps(velocity + i), _mm_mul_ps(_mm_loadu_ps(acceleration + i), step));
+		_mm_storeu_ps(velocity + i, v);
+		_mm_storeu_ps(position + i, _mm_add_ps(_mm_loadu_ps(position + i), _mm_mul_ps(v, step)));
+	}
+#endif
+	for (; i < count; i++) {
+		velocity[i] += acceleration[i] * dt;
+		position[i] += velocity[i] * dt;
+	} // The bodies left over after the last full register, or all of them without SSE.
+} // Semi-implicit Euler, with the multiplies and adds in the same order as Body::move() so the results match it exactly. Separate multiplies and adds are used rather than FMA for the same reason.
+
+static void unintegrate(float* position, float* velocity, const float* acceleration, int count, float dt)
+{
+	int i = 0;
+#if defined(__AVX__)
+	__m256 step = _mm256_set1_ps(dt);
+	for (; i + 8 <= count; i += 8) {
+		__m256 v = _mm256_loadu_ps(velocity + i);
+		_mm256_storeu_ps(position + i, _mm256_sub_ps(_mm256_loadu_ps(position + i), _mm256_mul_ps(v, step)));
+		_mm256_storeu_ps(velocity + i, _mm256_sub_ps(v, _mm256_mul_ps(_mm256_loadu_ps(acceleration + i), step)));
+	}
+#elif defined(KINEMATICS_SSE)
+	__m128 step = _mm_set1_ps(dt);
+	for (; i + 4 <= count; i += 4) {
+		__m128 v = _mm_loadu_ps(velocity + i);
+		_mm_storeu_ps(position + i, _mm_sub_ps(_mm_loadu_ps(position + i), _mm_mul_ps(v, step)));
+		_mm_storeu_ps(velocity + i, _mm_sub_ps(v, _mm_mul_ps(_mm_loadu_ps(acceleration + i), step)));
+	}
+#endif
+	for (; i < count; i++) {
+		position[i] -= velocity[i] * dt;
+		velocity[i] -= acceleration[i] * dt;
+	}
+} // The same steps as integrate(), undone in reverse order.
+
+static void integrateFixed(Fixed* position, Fixed* velocity, const Fixed* acceleration, int count)
+{
+	int i = 0;
+#if defined(__AVX2__)
+	for (; i + 8 <= count; i += 8) {
+		__m256i v = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(velocity + i)), _mm256_loadu_si256((const __m256i*)(acceleration + i)));
+		_mm256_storeu_si256((__m256i*)(velocity + i), v);
+		_mm256_storeu_si256((__m256i*)(position + i), _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(position + i)), v));
+	}
+#elif defined(__AVX__) || defined(KINEMATICS_SSE)
+	for (; i + 4 <= count; i += 4) {
+		__m128i v = _mm_add_epi32(_mm_loadu_si128((const __m128i*)(velocity + i)), _mm_loadu_si128((const __m128i*)(acceleration + i)));
+		_mm_storeu_si128((__m128i*)(velocity + i), v);
+		_mm_storeu_si128((__m128i*)(position + i), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(position + i)), v));
+	}
+#endif
+	for (; i < count; i++) {
+		velocity[i] += acceleration[i];
+		position[i] += velocity[i];
+	}
+} // The fixed-point step. Velocity and acceleration already have dt folded in, so it's two integer adds per axis, with no multiplies to round.
+
+static void unintegrateFixed(Fixed* position, Fixed* velocity, const Fixed* acceleration, int count)
+{
+	int i = 0;
+#if defined(__AVX2__)
+	for (; i + 8 <= count; i += 8) {
+		__m256i v = _mm256_loadu_si256((const __m256i*)(velocity + i));
+		_mm256_storeu_si256((__m256i*)(position + i), _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(position + i)), v));
+		_mm256_storeu_si256((__m256i*)(velocity + i), _mm256_sub_epi32(v, _mm256_loadu_si256((const __m256i*)(acceleration + i))));
+	}
+#elif defined(__AVX__) || defined(KINEMATICS_SSE)
+	for (; i + 4 <= count; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(velocity + i));
+		_mm_storeu_si128((__m128i*)(position + i), _mm_sub_epi32(_mm_loadu_si128((const __m128i*)(position + i)), v));
+		_mm_storeu_si128((__m128i*)(velocity + i), _mm_sub_epi32(v, _mm_loadu_si128((const __m128i*)(acceleration + i))));
+	}
+#endif
+	for (; i < count; i++) {
+		position[i] -= velocity[i];
+		velocity[i] -= acceleration[i];
+	}
+} // Undoes integrateFixed() exactly.
+
+void Kinematics::resize(int count)
+{
+	x.resize(count);
+	y.resize(count);
+	xPrime.resize(count);
+	yPrime.resize(count);
+	xPrimePrime.resize(count);
+	yPrimePrime.resize(count);
+	time.resize(count);
+	elapsed = 0;
+	fixed = Body::fixedPoint;
+	if (fixed) {
+		fixedX.resize(count);
+		fixedY.resize(count);
+		fixedXStep.resize(count);
+		fixedYStep.resize(count);
+		fixedXStepStep.resize(count);
+		fixedYStepStep.resize(count);
+	}
+}
+
+template <class T>
+void Kinematics::load(const vector<T>* queue)
+{
+	resize(queue->size());
+	const T* b = queue->data();
+	float *px = x.data(), *py = y.data(), *pxPrime = xPrime.data(), *pyPrime = yPrime.data(), *pxPrimePrime = xPrimePrime.data(), *pyPrimePrime = yPrimePrime.data();
+	for (unsigned int i = 0; i < queue->size(); i++) {
+		px[i] = b[i].x;
+		py[i] = b[i].y;
+		pxPrime[i] = b[i].xPrime;
+		pyPrime[i] = b[i].yPrime;
+		pxPrimePrime[i] = b[i].xPrimePrime;
+		pyPrimePrime[i] = b[i].yPrimePrime;
+		time[i] = b[i].time;
+	}
+
+	if (fixed) {
+		for (unsigned int i = 0; i < queue->size(); i++) {
+			Body::FixedState f = b[i].fixedState();
+			fixedX[i] = f.x;
+			fixedY[i] = f.y;
+			fixedXStep[i] = f.xStep;
+			fixedYStep[i] = f.yStep;
+			fixedXStepStep[i] = f.xStepStep;
+			fixedYStepStep[i] = f.yStepStep;
+		}
+	}
+} // The array pointers are copied into locals, since otherwise each store could alias a body's fields and force everything to be reloaded.
+
+template <class T>
+void Kinematics::store(vector<T>* queue) const
+{
+	T* b = queue->data();
+	const float *px = x.data(), *py = y.data(), *pxPrime = xPrime.data(), *pyPrime = yPrime.data();
+	for (unsigned int i = 0; i < queue->size(); i++) {
+		b[i].x = px[i];
+		b[i].y = py[i];
+		b[i].xPrime = pxPrime[i];
+		b[i].yPrime = pyPrime[i];
+		b[i].time = time[i] + elapsed;
+	}
+
+	if (fixed) {
+		for (unsigned int i = 0; i < queue->size(); i++)
+			b[i].setFixedState({fixedX[i], fixedY[i], fixedXStep[i], fixedYStep[i], fixedXStepStep[i], fixedYStepStep[i]});
+	} // Overwrites the float positions and velocities with the ones the fixed-point state rounds to.
+} // Acceleration is never changed by a step, so it isn't written back.
+
+void Kinematics::gather(const vector<Body>* queue)
+{
+	load(queue);
+}
+
+void Kinematics::gather(const vector<Surface>* queue)
+{
+	load(queue);
+}
+
+void Kinematics::scatter(vector<Body>* queue) const
+{
+	store(queue);
+}
+
+void Kinematics::scatter(vector<Surface>* queue) const
+{
+	store(queue);
+}
+
+void Kinematics::step(float dt)
+{
+	if (fixed) {
+		integrateFixed(fixedX.data(), fixedXStep.data(), fixedXStepStep.data(), fixedX.size());
+		integrateFixed(fixedY.data(), fixedYStep.data(), fixedYStepStep.data(), fixedY.size());
+		elapsed += Body::dt;
+		return;
+	}
+	integrate(x.data(), xPrime.data(), xPrimePrime.data(), x.size(), dt);
+	integrate(y.data(), yPrime.data(), yPrimePrime.data(), y.size(), dt);
+	elapsed += dt;
+}
+
+void Kinematics::reverseStep(float dt)
+{
+	if (fixed) {
+		unintegrateFixed(fixedX.data(), fixedXStep.data(), fixedXStepStep.data(), fixedX.size());
+		unintegrateFixed(fixedY.data(), fixedYStep.data(), fixedYStepStep.data(), fixedY.size());
+		elapsed -= Body::dt;
+		return;
+	}
+	unintegrate(x.data(), xPrime.data(), xPrimePrime.data(), x.size(), dt);
+	unintegrate(y.data(), yPrime.data(), yPrimePrime.data(), y.size(), dt);
+	elapsed -= dt;
+}
+
+template <class T>
+void Kinematics::advance(T* b, const int* index, int begin, int end, int reverseArg)
+{
+	float dt = Body::dt;
+	if (Body::fixedPoint || Body::integrator != Body::SEMI_IMPLICIT_EULER) {
+		for (int k = begin; k < end; k++)
+			b[index[k]].move(reverseArg);
+	} else if (reverseArg >= 0) {
+		for (int k = begin; k < end; k++) {
+			T& body = b[index[k]];
+			if (body.sleepState.asleep)
+				continue;
+			body.xPrime += body.xPrimePrime * dt;
+			body.yPrime += body.yPrimePrime * dt;
+			body.x += body.xPrime * dt;
+			body.y += body.yPrime * dt;
+			body.time += dt;
+		}
+	} else {
+		for (int k = begin; k < end; k++) {
+			T& body = b[index[k]];
+			if (body.sleepState.asleep)
+				continue;
+			body.y -= body.yPrime * dt;
+			body.x -= body.xPrime * dt;
+			body.yPrime -= body.yPrimePrime * dt;
+			body.xPrime -= body.xPrimePrime * dt;
+			body.time -= dt;
+		}
+	}
+} // The render queues hold whole entities, so copying them into the arrays and back costs more than the vector step saves. Stepping them in place at least avoids a call per body.
+
+template <class T>
+const vector<int>& Kinematics::awake(const vector<T>* queue, AwakeList& list)
+{
+	if (list.valid && list.data == queue->data() && list.size == queue->size() && list.epoch == Body::sleepEpoch)
+		return list.indices;
+
+	const T* b = queue->data();
+	list.indices.clear();
+	for (unsigned int i = 0; i < queue->size(); i++) {
+		if (!b[i].sleepState.asleep)
+			list.indices.push_back(i);
+	}
+	list.valid = true;
+	list.data = queue->data();
+	list.size = queue->size();
+	list.epoch = Body::sleepEpoch;
+	return list.indices;
+} // Bodies that fall asleep stay on the list until something else forces a rebuild, which costs them only the check in advance().
+
+template <class T>
+void Kinematics::advance(vector<T>* queue, int reverseArg, AwakeList& list)
+{
+	const vector<int>& indices = awake(queue, list);
+	T* b = queue->data();
+	const int* index = indices.data();
+	int count = indices.size();
+	if (jobs == nullptr || count < 2*PARALLEL_GRAIN) {
+		advance(b, index, 0, count, reverseArg);
+		return;
+	}
+	jobs->parallelFor(count, PARALLEL_GRAIN, [=](int begin, int end, int chunk) {
+		advance(b, index, begin, end, reverseArg);
+	});
+} // Bodies don't affect one another here, so splitting the queue up gives exactly the same results as stepping it in one go.
+
+void Kinematics::leap(Body& body, double time, float longest)
+{
+	if (body.sleepState.asleep)
+		return;
+	float h = std::min(static_cast<float>(time - body.time), longest);
+	if (h > 0) {
+		if (Body::fixedPoint) {
+			for (long ticks = std::lround(h / Body::dt); ticks > 0; ticks--) {
+				body.move();
+				if (body.isBouncy())
+					body.ifOnEdgeBounce();
+			}
+		} else if (body.isBouncy()) {
+			body.advanceBouncing(body.time + h);
+		} else {
+			body.step(h, Body::VELOCITY_VERLET);
+		}
+	} // Fixed point still goes a tick at a time, so it comes out bit for bit as it did before.
+	body.time = time;
+}
+
+void Kinematics::leap(Surface& surface, double time, float longest)
+{
+	if (!surface.followsPath()) {
+		leap(static_cast<Body&>(surface), time, longest);
+		return;
+	}
+	if (surface.sleepState.asleep)
+		return;
+	float h = std::min(static_cast<float>(time - surface.time), longest);
+	if (h > 0) {
+		if (Body::fixedPoint) {
+			for (long ticks = std::lround(h / Body::dt); ticks > 0; ticks--) {
+				surface.move();
+				surface.followPath(Body::dt);
+			}
+		} else {
+			surface.step(h, Body::VELOCITY_VERLET);
+			surface.followPath(h);
+		}
+	} // A path is closed-form, so it comes out the same however it's stepped.
+	surface.time = time;
+}
+
+template <class T>
+void Kinematics::leap(vector<T>* queue, double time, float longest, AwakeList& list)
+{
+	const vector<int>& indices = awake(queue, list);
+	T* b = queue->data();
+	const int* index = indices.data();
+	int count = indices.size();
+	if (jobs == nullptr || count < 2*PARALLEL_GRAIN) {
+		for (int k = 0; k < count; k++)
+			leap(b[index[k]], time, longest);
+		return;
+	}
+	jobs->parallelFor(count, PARALLEL_GRAIN, [=](int begin, int end, int chunk) {
+		for (int k = begin; k < end; k++)
+			leap(b[index[k]], time, longest);
+	});
+} // Awake bodies never wake anything, so nothing here touches Body::sleepEpoch from more than one thread.
+
+void Kinematics::leap(vector<Body>* queue, double time, float longest)
+{
+	leap(queue, time, longest, awakeBodies);
+}
+
+void Kinematics::leap(vector<Surface>* queue, double time, float longest)
+{
+	leap(queue, time, longest, awakeSurfaces);
+}
+
+void Kinematics::move(vector<Body>* queue, int reverseArg)
+{
+	advance(queue, reverseArg, awakeBodies);
+}
+
+void Kinematics::move(vector<Surface>* queue, int reverseArg)
+{
+	advance(queue, reverseArg, awakeSurfaces);
+}
+
+const vector<int>& Kinematics::awake(const vector<Body>* queue)
+{
+	return awake(queue, awakeBodies);
+}
+
+const vector<int>& Kinematics::awake(const vector<Surface>* queue)
+{
+	return awake(queue, awakeSurfaces);
+}
+
+void Kinematics::setJobSystem(JobSystem* jobs)
+{
+	this->jobs = jobs;
+}
+
+int Kinematics::size() const
+{
+	return x.size();
+}
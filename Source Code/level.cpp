@@ -0,0 +1,837 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <map>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+#include <Windows.h>
+
+#include "RenderWindow.hpp"
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "Level.hpp"
+
+using std::string;
+using std::abs;
+using std::pair;
+using std::vector;
+using std::map;
+using namespace gamefuncs;
+
+/* Level files come in two forms. The text form (.lvl) is what gets edited: one setting or element per line, # starts a comment,
+and elements are written as "type name prototype animCode x y xVelocity yVelocity size [hitbox]", where animCode is - for none.
+A surface can then be given a route with "path name pingpong|loop x1 y1 x2 y2 ...".
+The cooked form (.lvlc) is the same level laid out as a CookedHeader, an array of CookedElements, the path waypoints as x,y float
+pairs and a block of null-terminated strings that the elements point into by offset, so loading it is a single read followed by
+copying the records out. */
+
+struct CookedHeader
+{
+	char magic[4]; // Always "URGL".
+	Uint32 version;
+	float playerSize;
+	Uint32 flags; // Bit 0=floor, 1=ceiling, 2=left wall, 3=right wall, 4=door locked.
+	float locations[8]; // Player, door, camera and simul camera, as x,y pairs.
+	Uint32 backgrounds[2]; // Offsets into the string block.
+	Uint32 elementCount;
+	Uint32 waypointCount;
+	Uint32 stringBytes;
+};
+
+struct CookedElement
+{
+	Uint32 name, prototype; // Offsets into the string block.
+	char type, animCode;
+	Uint8 hitbox, pathLoops;
+	float x, y, xVelocity, yVelocity, size;
+	Uint32 pathStart, pathLength; // The element's waypoints, as an index into the waypoint block and a count.
+};
+
+static_assert(sizeof(CookedHeader) == 68 && sizeof(CookedElement) == 40, "The cooked level layout must not depend on the compiler's padding.");
+
+const Uint32 COOKED_LEVEL_VERSION = 2;
+
+static bool fileModifiedTime(const string& path, long long* time)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+		return false;
+	*time = info.st_mtime;
+	return true;
+} // Returns false if the file doesn't exist.
+
+static bool readFile(const string& path, string& buffer)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+
+	buffer.resize(file.tellg());
+	file.seekg(0);
+	file.read(&buffer[0], buffer.size());
+	return bool(file);
+} // Reads the whole file in one go; the parsers below work on the buffer directly.
+
+static int splitLine(const char* p, const char* end, const char* tokens[], int maxTokens)
+{
+	int count = 0;
+	while (p < end && count < maxTokens) {
+		while (p < end && (*p == ' ' || *p == '\t'))
+			p++;
+		if (p == end || *p == '#')
+			break;
+		tokens[count++] = p;
+		while (p < end && *p != ' ' && *p != '\t')
+			p++;
+	}
+	while (p < end && (*p == ' ' || *p == '\t'))
+		p++;
+	return (p < end && *p != '#') ? maxTokens+1 : count;
+} // Splits a line into whitespace-separated tokens, ignoring anything after a #. The tokens point into the buffer. Returns maxTokens+1 if the line has more tokens than that, so it can be rejected rather than cut short.
+
+static bool tokenEnd(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\0';
+}
+
+static string tokenString(const char* token)
+{
+	size_t length = 0;
+	while (!tokenEnd(token[length]))
+		length++;
+	return string(token, length);
+}
+
+static bool tokenFloats(const char* tokens[], int count, float* out)
+{
+	for (int i = 0; i < count; i++) {
+		char* parsed;
+		out[i] = std::strtof(tokens[i], &parsed);
+		if (parsed == tokens[i] || !tokenEnd(*parsed))
+			return false;
+	}
+	return true;
+} // strtof stops at the whitespace after each number, and the buffer is null-terminated, so nothing has to be copied out. A number must take up its whole token, so "12abc" is an error rather than 12.
+
+static bool tokenLocation(const char* tokens[], int count, pair<float,float>& location)
+{
+	if (count == 2 && tokenString(tokens[1]) == "offscreen") {
+		location = {-1000, -1000};
+		return true;
+	}
+	float coordinates[2];
+	if (count != 3 || !tokenFloats(tokens+1, 2, coordinates))
+		return false;
+	location = {coordinates[0], coordinates[1]};
+	return true;
+}
+
+static bool parseLevelText(const string& buffer, const string& path, Level& l)
+{
+	l = Level();
+	l.elements.reserve(64);
+
+	const char* p = buffer.c_str();
+	const char* end = p + buffer.size();
+	int lineNumber = 0;
+
+	while (p < end) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+		if (lineEnd == nullptr)
+			lineEnd = end;
+		lineNumber++;
+
+		const char* tokens[35];
+		int count = splitLine(p, (lineEnd > p && lineEnd[-1] == '\r') ? lineEnd-1 : lineEnd, tokens, 35); // Room for a path with 16 waypoints.
+		bool valid = count <= 35;
+
+		if (count > 0 && valid) {
+			string key = tokenString(tokens[0]);
+			float values[6];
+
+			if (key.size() == 1 && (key[0] == 'E' || key[0] == 'D' || key[0] == 'B' || key[0] == 'S')) {
+				valid = (count == 9 || count == 10) && tokenFloats(tokens+4, 5, values);
+				if (valid) {
+					LevelElement element;
+					element.objptr = nullptr;
+					element.type = key[0];
+					element.name = tokenString(tokens[1]);
+					element.prototype = tokenString(tokens[2]);
+					element.animCode = (tokens[3][0] == '-') ? '\0' : tokens[3][0];
+					element.coordinates = {values[0], values[1]};
+					element.velocities = {values[2], values[3]};
+					element.size = values[4];
+					element.hitbox = (count == 10 && tokens[9][0] == '1');
+					l.elements.push_back(element);
+				}
+			} else if (key == "path") {
+				LevelElement* element = nullptr;
+				for (LevelElement& e : l.elements) {
+					if (count >= 3 && e.name == tokenString(tokens[1]))
+						element = &e;
+				}
+				string mode = (count >= 3) ? tokenString(tokens[2]) : "";
+				float waypoints[32];
+				valid = element != nullptr && element->type == 'S' && (mode == "pingpong" || mode == "loop") && count > 3 && count % 2 == 1 && tokenFloats(tokens+3, count-3, waypoints);
+				if (valid) {
+					element->path.clear();
+					for (int i = 0; i < count-3; i += 2)
+						element->path.push_back({waypoints[i], waypoints[i+1]});
+					element->pathLoops = (mode == "loop");
+				}
+			} else if (key == "playerSize") {
+				valid = count == 2 && tokenFloats(tokens+1, 1, &l.playerSize);
+			} else if (key == "floor" || key == "ceiling" || key == "leftWall" || key == "rightWall" || key == "doorLocked") {
+				valid = count == 2;
+				bool flag = valid && tokens[1][0] == '1';
+				if (key == "floor")
+					l.floor = flag;
+				else if (key == "ceiling")
+					l.ceiling = flag;
+				else if (key == "leftWall")
+					l.leftWall = flag;
+				else if (key == "rightWall")
+					l.rightWall = flag;
+				else
+					l.doorLocked = flag;
+			} else if (key == "backgrounds") {
+				valid = count == 3;
+				if (valid)
+					l.backgroundNames = {tokenString(tokens[1]), tokenString(tokens[2])};
+			} else if (key == "player") {
+				valid = tokenLocation(tokens, count, l.playerLocation);
+			} else if (key == "door") {
+				valid = tokenLocation(tokens, count, l.doorLocation);
+			} else if (key == "camera") {
+				valid = tokenLocation(tokens, count, l.cameraLocation);
+			} else if (key == "simulCamera") {
+				valid = tokenLocation(tokens, count, l.simulCameraLocation);
+			} else {
+				valid = false;
+			}
+		}
+
+		if (!valid) {
+			std::cout << "Failed to parse level. Error: " << path << " line " << lineNumber << '\n';
+			return false;
+		}
+		p = lineEnd + 1;
+	}
+
+	return true;
+} // Fills in everything except the prototype pointers, which are resolved separately so that cooking doesn't need any textures.
+
+static bool readCookedLevel(const string& buffer, const string& path, Level& l)
+{
+	CookedHeader header;
+	if (buffer.size() < sizeof(header)) {
+		std::cout << "Failed to read cooked level. Error: " << path << " is truncated\n";
+		return false;
+	}
+	std::memcpy(&header, buffer.data(), sizeof(header));
+
+	if (std::memcmp(header.magic, "URGL", 4) != 0 || header.version != COOKED_LEVEL_VERSION) {
+		std::cout << "Failed to read cooked level. Error: " << path << " is not a version " << COOKED_LEVEL_VERSION << " cooked level\n";
+		return false;
+	}
+	size_t elementBytes = size_t(header.elementCount) * sizeof(CookedElement), waypointBytes = size_t(header.waypointCount) * 2 * sizeof(float);
+	if (buffer.size() != sizeof(header) + elementBytes + waypointBytes + header.stringBytes || header.stringBytes == 0 || buffer.back() != '\0') {
+		std::cout << "Failed to read cooked level. Error: " << path << " is truncated\n";
+		return false;
+	}
+
+	const char* waypoints = buffer.data() + sizeof(header) + elementBytes;
+	const char* strings = waypoints + waypointBytes;
+	auto stringAt = [&](Uint32 offset) { return string(offset < header.stringBytes ? strings + offset : ""); };
+
+	l = Level();
+	l.playerSize = header.playerSize;
+	l.floor = header.flags & 1;
+	l.ceiling = header.flags & 2;
+	l.leftWall = header.flags & 4;
+	l.rightWall = header.flags & 8;
+	l.doorLocked = header.flags & 16;
+	l.playerLocation = {header.locations[0], header.locations[1]};
+	l.doorLocation = {header.locations[2], header.locations[3]};
+	l.cameraLocation = {header.locations[4], header.locations[5]};
+	l.simulCameraLocation = {header.locations[6], header.locations[7]};
+	l.backgroundNames = {stringAt(header.backgrounds[0]), stringAt(header.backgrounds[1])};
+
+	l.elements.resize(header.elementCount);
+	const char* record = buffer.data() + sizeof(header);
+	for (LevelElement& element : l.elements) {
+		CookedElement cooked;
+		std::memcpy(&cooked, record, sizeof(cooked));
+		record += sizeof(cooked);
+
+		element.objptr = nullptr;
+		element.type = cooked.type;
+		element.animCode = cooked.animCode;
+		element.coordinates = {cooked.x, cooked.y};
+		element.velocities = {cooked.xVelocity, cooked.yVelocity};
+		element.size = cooked.size;
+		element.hitbox = cooked.hitbox;
+		element.name = stringAt(cooked.name);
+		element.prototype = stringAt(cooked.prototype);
+
+		if (cooked.pathLength > 0 && cooked.pathStart <= header.waypointCount && cooked.pathLength <= header.waypointCount - cooked.pathStart) {
+			element.path.resize(cooked.pathLength);
+			for (Uint32 i = 0; i < cooked.pathLength; i++) {
+				float point[2];
+				std::memcpy(point, waypoints + (cooked.pathStart + i) * sizeof(point), sizeof(point));
+				element.path[i] = {point[0], point[1]};
+			}
+			element.pathLoops = cooked.pathLoops;
+		}
+	}
+
+	return true;
+}
+
+static bool writeCookedLevel(const Level& l, const string& path)
+{
+	string strings;
+	map<string, Uint32> offsets;
+	auto intern = [&](const string& s) {
+		auto found = offsets.find(s);
+		if (found != offsets.end())
+			return found->second;
+		Uint32 offset = strings.size();
+		strings.append(s);
+		strings.push_back('\0');
+		offsets[s] = offset;
+		return offset;
+	}; // Prototype names repeat a lot, so each distinct string is only stored once.
+
+	CookedHeader header = {};
+	std::memcpy(header.magic, "URGL", 4);
+	header.version = COOKED_LEVEL_VERSION;
+	header.playerSize = l.playerSize;
+	header.flags = l.floor | l.ceiling << 1 | l.leftWall << 2 | l.rightWall << 3 | l.doorLocked << 4;
+	float locations[8] = {l.playerLocation.first, l.playerLocation.second, l.doorLocation.first, l.doorLocation.second, l.cameraLocation.first, l.cameraLocation.second, l.simulCameraLocation.first, l.simulCameraLocation.second};
+	std::memcpy(header.locations, locations, sizeof(locations));
+	header.backgrounds[0] = intern(l.backgroundNames.first);
+	header.backgrounds[1] = intern(l.backgroundNames.second);
+	header.elementCount = l.elements.size();
+
+	vector<CookedElement> records(l.elements.size());
+	vector<float> waypoints;
+	for (size_t i = 0; i < l.elements.size(); i++) {
+		const LevelElement& element = l.elements[i];
+		records[i] = {intern(element.name), intern(element.prototype), element.type, element.animCode, Uint8(element.hitbox), Uint8(element.pathLoops), element.coordinates.first, element.coordinates.second, element.velocities.first, element.velocities.second, element.size, Uint32(waypoints.size() / 2), Uint32(element.path.size())};
+		for (const pair<float,float>& point : element.path) {
+			waypoints.push_back(point.first);
+			waypoints.push_back(point.second);
+		}
+	}
+	header.waypointCount = waypoints.size() / 2;
+	header.stringBytes = strings.size();
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CookedElement));
+	file.write(reinterpret_cast<const char*>(waypoints.data()), waypoints.size() * sizeof(float));
+	file.write(strings.data(), strings.size());
+
+	if (!file) {
+		std::cout << "Failed to write cooked level. Error: " << path << '\n';
+		return false;
+	}
+	return true;
+}
+
+static bool resolvePrototypes(Level& l, const PrototypeRegistry& prototypes, const string& path)
+{
+	bool resolved = true;
+	auto lookUp = [&](const string& name) -> const Entity* {
+		auto found = prototypes.find(name);
+		if (found != prototypes.end())
+			return found->second;
+		std::cout << "Failed to resolve prototype. Error: " << path << " uses unknown prototype " << name << '\n';
+		resolved = false;
+		return nullptr;
+	};
+
+	l.backgrounds = {lookUp(l.backgroundNames.first), lookUp(l.backgroundNames.second)};
+	for (unsigned int i = 0; i < l.elements.size(); i++) {
+		LevelElement& element = l.elements[i];
+		element.objptr = lookUp(element.prototype);
+		element.id = i+1;
+		if ((element.type == 'S' && dynamic_cast<const Surface*>(element.objptr) == nullptr) || (element.type == 'B' && dynamic_cast<const Body*>(element.objptr) == nullptr)) {
+			if (element.objptr != nullptr)
+				std::cout << "Failed to resolve prototype. Error: " << path << " uses " << element.prototype << " as a " << ((element.type == 'S') ? "surface" : "body") << ", which it isn't\n";
+			element.objptr = nullptr;
+			resolved = false;
+		}
+	} // addInstance() copies S and B elements out of their prototypes as Surfaces and Bodies, so the prototype has to really be one.
+
+	return resolved;
+}
+
+static Path elementPath(const LevelElement& element)
+{
+	return Path(element.coordinates, std::hypot(element.velocities.first, element.velocities.second), element.path, element.pathLoops);
+} // Only the speed is taken from the element's velocity; the direction comes from the path.
+
+template <typename T>
+static T& placeInstance(vector<T>* queue, const T& instance, int at)
+{
+	if (at < 0) {
+		queue->push_back(instance);
+		return queue->back();
+	}
+	queue->at(at) = instance;
+	return queue->at(at);
+}
+
+template <typename T>
+static void place(vector<T>* queue, const T& value, int at)
+{
+	if (at < 0)
+		queue->push_back(value);
+	else
+		queue->at(at) = value;
+} // For the queues kept alongside the render queues.
+
+static void addInstance(const LevelElement& element, QueueSet& q, int at = -1)
+{
+	switch (element.type)
+	{
+		case 'S':
+		{
+			Surface& s = placeInstance(q.queue5, *static_cast<const Surface*>(element.objptr), at);
+			s.setCoords(element.coordinates.first, element.coordinates.second);
+			s.setXPrime(element.velocities.first);
+			s.setYPrime(element.velocities.second);
+			if (!element.path.empty())
+				s.setPath(elementPath(element));
+			s.sleep();
+			s.setInstanceId(element.id);
+			place(q.sizeQueue5, element.size, at);
+			place(q.animQueue, element.animCode, at);
+			break;
+		}
+		case 'B':
+		{
+			Body& b = placeInstance(q.queue4, *static_cast<const Body*>(element.objptr), at);
+			b.setCoords(element.coordinates.first, element.coordinates.second);
+			b.setXPrime(element.velocities.first);
+			b.setYPrime(element.velocities.second);
+			b.sleep();
+			b.setInstanceId(element.id);
+			place(q.sizeQueue4, element.size, at);
+			place(q.hboxQueue, element.hitbox, at);
+			break;
+		}
+		case 'D':
+		{
+			Entity& e = placeInstance(q.queue2, *element.objptr, at);
+			e.setCoords(element.coordinates.first, element.coordinates.second);
+			e.setInstanceId(element.id);
+			place(q.sizeQueue2, element.size, at);
+			break;
+		}
+		case 'E':
+		{
+			Entity& e = placeInstance(q.queue3, *element.objptr, at);
+			e.setCoords(element.coordinates.first, element.coordinates.second);
+			e.setInstanceId(element.id);
+			place(q.sizeQueue3, element.size, at);
+			break;
+		}
+	}
+} // The element is copied from its prototype straight into the queue, at the end or over the instance at index at, and then positioned there, so the prototype itself is left untouched. Elements that don't move are put to sleep.
+
+bool levelLoaded(const Level& l)
+{
+	return l.backgrounds.first != nullptr && l.backgrounds.second != nullptr;
+}
+
+bool loadLevel(const Level& l, Body& p, QueueSet& q, Entity& door, Entity& cam1, Entity& cam2)
+{
+	if (!levelLoaded(l)) {
+		std::cout << "Failed to load level. Error: it could not be read from its file\n";
+		return false;
+	}
+
+	clearEntities(q.queue5, q.sizeQueue5, q.animQueue);
+	clearEntities(q.queue4, q.sizeQueue4, q.hboxQueue);
+	clearEntities(q.queue3, q.sizeQueue3);
+	clearEntities(q.queue2, q.sizeQueue2);
+	q.queue1->clear();
+
+	unsigned int surfaceCount = 4, bodyCount = 0, decorationCount = 0, objectCount = 3; // The 4 extra surfaces leave room for the implicit borders, and the 3 extra objects are the door and cameras.
+	for (const LevelElement& element : l.elements) {
+		switch (element.type)
+		{
+			case 'S':
+				surfaceCount++;
+				break;
+			case 'B':
+				bodyCount++;
+				break;
+			case 'D':
+				decorationCount++;
+				break;
+			case 'E':
+				objectCount++;
+				break;
+		}
+	}
+	q.queue5->reserve(surfaceCount); q.sizeQueue5->reserve(surfaceCount); q.animQueue->reserve(surfaceCount);
+	q.queue4->reserve(bodyCount); q.sizeQueue4->reserve(bodyCount); q.hboxQueue->reserve(bodyCount);
+	q.queue2->reserve(decorationCount); q.sizeQueue2->reserve(decorationCount);
+	q.queue3->reserve(objectCount); q.sizeQueue3->reserve(objectCount); // The queues keep their capacity when cleared, so after the first few levels this allocates nothing.
+
+	p.setCoords(l.playerLocation.first, l.playerLocation.second);
+	q.queue1->push_back(*l.backgrounds.first);
+	q.queue1->push_back(*l.backgrounds.second);
+
+	door.setCoords(l.doorLocation.first, l.doorLocation.second);
+	displayEntity(q.queue3, q.sizeQueue3, door, 0.65);
+	cam1.setCoords(l.cameraLocation.first, l.cameraLocation.second);
+	displayEntity(q.queue3, q.sizeQueue3, cam1, 0.4);
+	cam2.setCoords(l.simulCameraLocation.first, l.simulCameraLocation.second);
+	displayEntity(q.queue3, q.sizeQueue3, cam2, 0.4);
+
+	for (const LevelElement& element : l.elements)
+		addInstance(element, q);
+
+	p.jump(0);
+	return true;
+} // Sets up the objects in the levels to be rendered.
+
+void fireMissile(QueueSet& q, const Surface& missile, float x, float y, double tilt, float direction)
+{
+	Surface shot = missile;
+	shot.stop();
+	shot.setTilt(tilt);
+	shot.setCoords(x, y);
+	shot.addVelVector(direction, 40);
+	displayEntity(q.queue5, q.sizeQueue5, q.animQueue, shot, 1.2, 'M');
+} // Launches a copy of the missile prototype from (x,y), so the prototype itself is never moved.
+
+const LevelElement* findElement(const Level& l, const string& name)
+{
+	for (const LevelElement& element : l.elements) {
+		if (element.name == name)
+			return &element;
+	}
+	std::cout << "Failed to find level element. Error: " << name << '\n';
+	return nullptr;
+}
+
+static float randomIn(float low, float high)
+{
+	return low + (high - low) * (std::rand() / static_cast<float>(RAND_MAX));
+}
+
+static void addStressElements(Level& l, int count, char type, const char* prototype, char animCode, const char* name, float width, float height)
+{
+	for (int i = 0; i < count; i++) {
+		LevelElement element;
+		element.type = type;
+		element.animCode = animCode;
+		element.prototype = prototype;
+		element.name = name + std::to_string(i+1);
+		element.coordinates = {randomIn(0, width - 200), randomIn(0, height - 50)};
+		element.velocities = {0, 0};
+		element.size = 1;
+		l.elements.push_back(element);
+	}
+}
+
+bool generateLevel(const StressSpec& spec, const PrototypeRegistry& prototypes, Level& l)
+{
+	l = Level();
+	l.playerSize = 0.4;
+	l.floor = l.ceiling = l.leftWall = l.rightWall = true;
+	l.doorLocked = false;
+	l.backgroundNames = {"backgrounda", "backgrounda"};
+	l.playerLocation = {100, 100};
+	l.doorLocation = {1313, 600};
+	l.cameraLocation = {-1000, -1000};
+	l.simulCameraLocation = {-1000, -1000};
+	l.elements.reserve(spec.staticSurfaces + spec.movingPlatforms + spec.bouncyBodies + spec.hazards + spec.missiles);
+	std::srand(spec.seed);
+
+	int first = l.elements.size();
+	addStressElements(l, spec.staticSurfaces, 'S', "solidPlatform", '\0', "static", spec.width, spec.height);
+	for (unsigned int i = first; i < l.elements.size(); i++)
+		l.elements[i].size = randomIn(0.5, 1);
+
+	first = l.elements.size();
+	addStressElements(l, spec.movingPlatforms, 'S', "semisolidPlatform", '\0', "moving", spec.width, spec.height);
+	for (unsigned int i = first; i < l.elements.size(); i++) {
+		LevelElement& e = l.elements[i];
+		float speed = randomIn(5, 20) * (std::rand() % 2 ? 1 : -1);
+		e.velocities = (i % 2) ? pair<float,float>(speed, 0) : pair<float,float>(0, speed);
+		e.size = 0.6;
+		if (i % 4 == 0) {
+			float reach = randomIn(100, 300) * (speed < 0 ? -1 : 1);
+			pair<float,float> end = (e.velocities.first != 0) ? pair<float,float>(e.coordinates.first + reach, e.coordinates.second) : pair<float,float>(e.coordinates.first, e.coordinates.second + reach);
+			e.path = {e.coordinates, end};
+			e.pathLoops = false;
+		}
+	} // A path starts where the platform does and runs the way it was already heading, so it goes back and forth along it.
+
+	first = l.elements.size();
+	addStressElements(l, spec.bouncyBodies, 'B', "movingBody", '\0', "body", spec.width, spec.height);
+	for (unsigned int i = first; i < l.elements.size(); i++) {
+		LevelElement& e = l.elements[i];
+		e.velocities = {randomIn(-25, 25), randomIn(-25, 25)};
+		e.size = randomIn(0.1, 0.2);
+		e.hitbox = i % 2;
+	}
+
+	first = l.elements.size();
+	addStressElements(l, spec.hazards, 'S', "dmgPlatform", '\0', "hazard", spec.width, spec.height);
+	for (unsigned int i = first; i < l.elements.size(); i++)
+		l.elements[i].size = 0.5;
+
+	first = l.elements.size();
+	addStressElements(l, spec.missiles, 'S', "missile", 'M', "missile", spec.width, spec.height);
+	for (unsigned int i = first; i < l.elements.size(); i++) {
+		l.elements[i].velocities = {(i % 2) ? 40.0f : -40.0f, 0};
+		l.elements[i].size = 1.2;
+	} // Missiles fly level, at the speed fireMissile() gives them.
+
+	return resolvePrototypes(l, prototypes, "generated level");
+} // Each kind is added in one run, so it takes up one contiguous stretch of its render queue.
+
+bool loadLevelFile(const string& path, const PrototypeRegistry& prototypes, Level& l)
+{
+	string textPath = path + ".lvl", cookedPath = path + ".lvlc";
+	long long textTime = 0, cookedTime = 0;
+	bool hasText = fileModifiedTime(textPath, &textTime);
+	bool hasCooked = fileModifiedTime(cookedPath, &cookedTime);
+	string buffer;
+	bool parsed = false;
+
+	if (hasCooked && (!hasText || cookedTime >= textTime) && readFile(cookedPath, buffer))
+		parsed = readCookedLevel(buffer, cookedPath, l);
+	if (!parsed && hasText) {
+		if (!readFile(textPath, buffer)) {
+			std::cout << "Failed to open level. Error: " << textPath << '\n';
+			return false;
+		}
+		parsed = parseLevelText(buffer, textPath, l);
+	} // A stale or unreadable cooked file falls back to the text, so editing a .lvl never requires re-cooking.
+
+	if (!parsed) {
+		if (!hasText && !hasCooked)
+			std::cout << "Failed to open level. Error: " << textPath << '\n';
+		return false;
+	}
+	return resolvePrototypes(l, prototypes, path);
+}
+
+int loadLevels(const string& directory, const PrototypeRegistry& prototypes, vector<Level>& levels)
+{
+	long long time;
+	int loaded = 0;
+	for (int n = 1; ; n++) {
+		string path = directory + "/level" + std::to_string(n);
+		if (!fileModifiedTime(path + ".lvl", &time) && !fileModifiedTime(path + ".lvlc", &time))
+			break;
+
+		levels.emplace_back();
+		if (loadLevelFile(path, prototypes, levels.back())) {
+			loaded++;
+		} else {
+			levels.back() = Level();
+			levels.back().playerSize = 1;
+			std::cout << "Skipped level " << n << ". Error: " << path << " could not be loaded.\n";
+		}
+	}
+	return loaded;
+} // A level that fails to load is left empty rather than dropped, so the ones after it keep their numbers, and fixing the file hot-reloads it.
+
+bool cookLevelFile(const string& path)
+{
+	string buffer;
+	Level l;
+	if (!readFile(path + ".lvl", buffer)) {
+		std::cout << "Failed to open level. Error: " << path << ".lvl\n";
+		return false;
+	}
+	return parseLevelText(buffer, path + ".lvl", l) && writeCookedLevel(l, path + ".lvlc");
+}
+
+int cookLevels(const string& directory)
+{
+	long long time;
+	int n = 1;
+	while (fileModifiedTime(directory + "/level" + std::to_string(n) + ".lvl", &time) && cookLevelFile(directory + "/level" + std::to_string(n)))
+		n++;
+	return n-1;
+}
+
+static void removeElementInstance(const LevelElement& element, QueueSet& q)
+{
+	switch (element.type)
+	{
+		case 'S':
+			removeInstance(q.queue5, q.sizeQueue5, q.animQueue, element.id);
+			break;
+		case 'B':
+			removeInstance(q.queue4, q.sizeQueue4, q.hboxQueue, element.id);
+			break;
+		case 'D':
+			removeInstance(q.queue2, q.sizeQueue2, element.id);
+			break;
+		case 'E':
+			removeInstance(q.queue3, q.sizeQueue3, element.id);
+			break;
+	}
+}
+
+static int instanceIndex(const LevelElement& element, const QueueSet& q)
+{
+	switch (element.type)
+	{
+		case 'S':
+			return findInstance(q.queue5, element.id);
+		case 'B':
+			return findInstance(q.queue4, element.id);
+		case 'D':
+			return findInstance(q.queue2, element.id);
+		case 'E':
+			return findInstance(q.queue3, element.id);
+	}
+	return -1;
+}
+
+static void updateInstance(const LevelElement& element, QueueSet& q)
+{
+	float x = element.coordinates.first, y = element.coordinates.second;
+	int i;
+	switch (element.type)
+	{
+		case 'S':
+			i = findInstance(q.queue5, element.id);
+			if (i >= 0) {
+				Surface& s = q.queue5->at(i);
+				s.setCoords(x, s.isVanished() ? y+9999 : y);
+				s.setXPrime(element.velocities.first);
+				s.setYPrime(element.velocities.second);
+				s.setPath(elementPath(element));
+				q.sizeQueue5->at(i) = element.size;
+				q.animQueue->at(i) = element.animCode;
+			}
+			break;
+		case 'B':
+			i = findInstance(q.queue4, element.id);
+			if (i >= 0) {
+				Body& b = q.queue4->at(i);
+				b.setCoords(x, b.isVanished() ? y+9999 : y);
+				b.setXPrime(element.velocities.first);
+				b.setYPrime(element.velocities.second);
+				q.sizeQueue4->at(i) = element.size;
+				q.hboxQueue->at(i) = element.hitbox;
+			}
+			break;
+		case 'D':
+			i = findInstance(q.queue2, element.id);
+			if (i >= 0) {
+				q.queue2->at(i).setCoords(x, q.queue2->at(i).isVanished() ? y+9999 : y);
+				q.sizeQueue2->at(i) = element.size;
+			}
+			break;
+		case 'E':
+			i = findInstance(q.queue3, element.id);
+			if (i >= 0) {
+				q.queue3->at(i).setCoords(x, q.queue3->at(i).isVanished() ? y+9999 : y);
+				q.sizeQueue3->at(i) = element.size;
+			}
+			break;
+	}
+} // Vanished instances (collected keys and the like) are moved but stay vanished.
+
+int patchLevel(const Level& current, Level& edited, QueueSet& q)
+{
+	map<string, const LevelElement*> previous;
+	int nextId = 1, patched = 0;
+	for (const LevelElement& element : current.elements) {
+		previous[element.name] = &element;
+		nextId = std::max(nextId, element.id+1);
+	}
+
+	for (LevelElement& element : edited.elements) {
+		auto found = previous.find(element.name);
+		if (found == previous.end()) {
+			element.id = nextId++;
+			addInstance(element, q);
+			patched++;
+			continue;
+		} // Added elements, and duplicate names after the first, get a fresh id.
+
+		const LevelElement& old = *found->second;
+		previous.erase(found);
+		element.id = old.id;
+
+		if (element.type != old.type || element.objptr != old.objptr) {
+			int at = (element.type == old.type) ? instanceIndex(old, q) : -1; // A new prototype replaces the instance where it is, so it keeps its place in the draw order. Only a change of type moves it to another queue.
+			if (at < 0)
+				removeElementInstance(old, q);
+			addInstance(element, q, at);
+			patched++;
+		} else if (element.coordinates != old.coordinates || element.velocities != old.velocities || element.size != old.size || element.animCode != old.animCode || element.hitbox != old.hitbox || element.path != old.path || element.pathLoops != old.pathLoops) {
+			updateInstance(element, q);
+			patched++;
+		} // Unchanged elements are left exactly as they are, so moving platforms keep moving from wherever they've got to.
+	}
+
+	for (auto& removed : previous) {
+		removeElementInstance(*removed.second, q);
+		patched++;
+	}
+
+	if (q.queue1->size() >= 2 && edited.backgrounds != current.backgrounds) {
+		q.queue1->at(0) = *edited.backgrounds.first;
+		q.queue1->at(1) = *edited.backgrounds.second;
+	}
+	if (q.queue3->size() >= 3) {
+		if (edited.doorLocation != current.doorLocation)
+			q.queue3->at(0).setCoords(edited.doorLocation.first, edited.doorLocation.second);
+		if (edited.cameraLocation != current.cameraLocation)
+			q.queue3->at(1).setCoords(edited.cameraLocation.first, edited.cameraLocation.second);
+		if (edited.simulCameraLocation != current.simulCameraLocation)
+			q.queue3->at(2).setCoords(edited.simulCameraLocation.first, edited.simulCameraLocation.second);
+	} // The door and cameras are always the first three objects; see loadLevel().
+
+	return patched;
+} // The player's location, size and the implicit borders are part of the player's state or set up by main.cpp, so edits to them only apply the next time the level is loaded.
+
+LevelWatcher::LevelWatcher(const string& directory)
+{
+	notification = FindFirstChangeNotificationA(directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+	if (notification == INVALID_HANDLE_VALUE)
+		std::cout << "Failed to watch level directory. Error: " << directory << '\n';
+}
+
+LevelWatcher::~LevelWatcher()
+{
+	if (notification != INVALID_HANDLE_VALUE)
+		FindCloseChangeNotification(notification);
+}
+
+bool LevelWatcher::changed()
+{
+	if (notification == INVALID_HANDLE_VALUE || WaitForSingleObject(notification, 0) != WAIT_OBJECT_0)
+		return false;
+
+	FindNextChangeNotification(notification);
+	return true;
+} // Windows reports that something in the directory changed but not what, so the caller reloads the levels and lets patchLevel() work out the difference.
@@ -0,0 +1,185 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "LightDelay.hpp"
+
+LightDelay::LightDelay()
+: tracks(MAX_TRACKS)
+{
+	for (int t = MAX_TRACKS - 1; t >= 0; t--)
+		freeTracks.push_back(t);
+}
+
+void LightDelay::setObserver(float x, float y, float lightSpeed)
+{
+	observerX = x;
+	observerY = y;
+	this->lightSpeed = lightSpeed;
+}
+
+void LightDelay::update(const vector<Body>* bodies, const vector<Surface>* surfaces, const Body& player, int now)
+{
+	if (now < lastTick)
+		clear(); // The level timer starts again from 0 with each level, which would leave the history in the future.
+	lastTick = now;
+
+	for (unsigned int i = 0; i < bodies->size(); i++)
+		follow(bodies->at(i), i, bodySlots, now);
+	trim(bodySlots, bodies->size());
+	for (unsigned int i = 0; i < surfaces->size(); i++)
+		follow(surfaces->at(i), i, surfaceSlots, now);
+	trim(surfaceSlots, surfaces->size());
+	follow(player, 0, playerSlots, now);
+}
+
+template <class T> void LightDelay::follow(const T& e, int index, Slots& slots, int now)
+{
+	if (index >= static_cast<int>(slots.track.size())) {
+		slots.track.resize(index+1, -1);
+		slots.offset.resize(index+1, {0, 0});
+	}
+
+	float x = e.getX(), y = e.getY();
+	if (slots.track[index] < 0) {
+		if (e.isAsleep() || (e.getXPrime() == 0 && e.getYPrime() == 0) || freeTracks.empty())
+			return;
+		slots.track[index] = freeTracks.back();
+		freeTracks.pop_back();
+		Track& t = tracks[slots.track[index]];
+		t.count = 0;
+		t.still = 0;
+		t.lastX = x;
+		t.lastY = y;
+	} // Sleeping and static entities are always where they're seen, so they get no history.
+
+	Track& t = tracks[slots.track[index]];
+	float jump = std::max(std::abs(x - t.lastX), std::abs(y - t.lastY));
+	float reach = 2*(std::abs(e.getXPrime()) + std::abs(e.getYPrime()))*Body::dt + 4;
+	if (t.count > 0 && jump > reach)
+		t.count = 0; // Teleported, or removeEntity() has moved another entity into this index. Either way its history isn't this one's.
+	t.still = (jump == 0) ? t.still + 1 : 0;
+	t.lastX = x;
+	t.lastY = y;
+
+	if (t.still > SAMPLES*STRIDE) {
+		release(slots, index);
+		return;
+	} // It has stood still for longer than the history reaches back, so it's already seen where it is.
+
+	record(t, x, y, now);
+	pair<float,float> seen = solve(t, x, y, now);
+	slots.offset[index] = {seen.first - x, seen.second - y};
+}
+
+void LightDelay::record(Track& t, float x, float y, int now)
+{
+	if (t.count > 0 && now - t.tick[t.newest] < STRIDE)
+		return;
+	t.newest = (t.newest + 1) % SAMPLES;
+	t.x[t.newest] = x;
+	t.y[t.newest] = y;
+	t.tick[t.newest] = now;
+	t.count = std::min(t.count + 1, SAMPLES);
+}
+
+pair<float,float> LightDelay::solve(const Track& t, float x, float y, int now) const
+{
+	auto sample = [&](int j) {
+		if (j == t.count)
+			return std::make_pair(x, y);
+		int r = (t.newest - (t.count - 1 - j) + SAMPLES) % SAMPLES;
+		return std::make_pair(t.x[r], t.y[r]);
+	}; // j counts from the oldest sample. j == count is where the entity is now.
+	auto age = [&](int j) {
+		return (j == t.count) ? 0 : now - t.tick[(t.newest - (t.count - 1 - j) + SAMPLES) % SAMPLES];
+	};
+	auto lag = [&](int j) {
+		pair<float,float> p = sample(j);
+		float dx = p.first - observerX, dy = p.second - observerY;
+		return age(j) * lightSpeed - std::sqrt(dx*dx + dy*dy);
+	}; // How far light from sample j has got past the observer. It falls towards the present for anything slower than light, so there's one crossing to find.
+
+	if (lag(0) < 0)
+		return sample(0); // The history doesn't reach back far enough yet, so the oldest position is the best there is.
+
+	int lo = 0, hi = t.count;
+	float loLag = lag(0), hiLag = lag(t.count);
+	while (hi - lo > 1) {
+		int mid = (lo + hi)/2;
+		float midLag = lag(mid);
+		if (midLag >= 0) {
+			lo = mid;
+			loLag = midLag;
+		} else {
+			hi = mid;
+			hiLag = midLag;
+		}
+	}
+
+	float s = (loLag - hiLag > 0) ? loLag / (loLag - hiLag) : 0;
+	pair<float,float> a = sample(lo), b = sample(hi);
+	return {a.first + s*(b.first - a.first), a.second + s*(b.second - a.second)};
+} // Six lookups for a full ring, and the motion between samples is close enough to a straight line to interpolate along.
+
+void LightDelay::release(Slots& slots, int index)
+{
+	if (slots.track[index] >= 0)
+		freeTracks.push_back(slots.track[index]);
+	slots.track[index] = -1;
+	slots.offset[index] = {0, 0};
+}
+
+void LightDelay::trim(Slots& slots, int count)
+{
+	for (int i = count; i < static_cast<int>(slots.track.size()); i++)
+		release(slots, i);
+	if (count < static_cast<int>(slots.track.size())) {
+		slots.track.resize(count);
+		slots.offset.resize(count);
+	}
+}
+
+void LightDelay::clear()
+{
+	trim(bodySlots, 0);
+	trim(surfaceSlots, 0);
+	trim(playerSlots, 0);
+}
+
+pair<float,float> LightDelay::bodyOffset(int index) const
+{
+	return (index < static_cast<int>(bodySlots.offset.size())) ? bodySlots.offset[index] : pair<float,float>(0, 0);
+}
+
+pair<float,float> LightDelay::surfaceOffset(int index) const
+{
+	return (index < static_cast<int>(surfaceSlots.offset.size())) ? surfaceSlots.offset[index] : pair<float,float>(0, 0);
+}
+
+pair<float,float> LightDelay::playerOffset() const
+{
+	return playerSlots.offset.empty() ? pair<float,float>(0, 0) : playerSlots.offset[0];
+}
+
+int LightDelay::tracked() const
+{
+	return MAX_TRACKS - freeTracks.size();
+}
+
+int LightDelay::memory() const
+{
+	return tracks.capacity()*sizeof(Track) + freeTracks.capacity()*sizeof(int);
+}
\ No newline at end of file
@@ -4,7 +4,7 @@ and exploit the fixed speed of light to induce time dilation, length contraction
 to reach the end of each level. 
 Controls and other information are displayed in-game. 
 The implementation of the basic sprite-displaying system is in entity.cpp and renderwindow.cpp, while the physics engine implementation is in body.cpp. 
-The relativistic effects are governed by the FrameOfReference and lorentzFactor structs. */
+The relativistic effects are governed by the FrameOfReference struct and the RelativityEngine in relativity.cpp. */
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
@@ -14,14 +14,31 @@ The relativistic effects are governed by the FrameOfReference and lorentzFactor
 #include <map>
 #include <vector>
 #include <cmath>
+#include <cstdlib>
 #include <cassert>
 #include <Windows.h>
 
 #include "RenderWindow.hpp"
 #include "Entity.hpp"
+#include "Fixed.hpp"
 #include "Body.hpp"
+#include "Path.hpp"
 #include "Surface.hpp"
 #include "GameFuncs.hpp"
+#include "Level.hpp"
+#include "JobSystem.hpp"
+#include "SpatialGrid.hpp"
+#include "Contacts.hpp"
+#include "Proximity.hpp"
+#include "Relativity.hpp"
+#include "Kinematics.hpp"
+#include "EventScheduler.hpp"
+#include "TimerWheel.hpp"
+#include "LightDelay.hpp"
+#include "Aberration.hpp"
+#include "DopplerAudio.hpp"
+#include "VoiceManager.hpp"
+#include "Benchmark.hpp"
 
 #define theBackground backgroundRenderQueue[i]
 #define theBackgroundObj backgroundObjRenderQueue[i]
@@ -39,150 +56,58 @@ using std::vector;
 using std::map;
 using namespace gamefuncs;
 
-const float SPEED_OF_LIGHT = 299792458.0; // in m/s.
-
-struct FrameOfReference
-{
-	bool playerInFrame;
-	float velocity; // With respect to Earth.
-}; // It's an inertial frame of reference, of course.
-
-float lorentzFactor(FrameOfReference s, FrameOfReference sPrime)
-{
-	float v = sPrime.velocity - s.velocity; // The velocity of the relative motion between the two frames.
-	float c = SPEED_OF_LIGHT;
-	return 1/sqrt(1 - (v*v)/(c*c)); // This formula is shown on several of the decorational blackboards in the game.
-}
-
-float dopplerFactor(float lorentz)
-{
-	float beta = 1 - (1/(lorentz*lorentz));
-	return sqrt((1 - beta)/(1 + beta));
-} // The factor governing the relativistic doppler effect, i.e. by which light frequencies are multiplied.
-
-pair<Uint8,Uint8> dopplerShift(float dFactor) 
-{
-	pair<Uint8,Uint8> shiftAmounts;
-
-	shiftAmounts.first = -99.6*dFactor + 139.84;
-	shiftAmounts.second = -9.96*dFactor + 13.984; // These scale the redshift, so it's not too exaggerated.
-
-	return shiftAmounts;
-}
-
-struct QueueSet
-{
-	vector<Entity>* queue1;
-	vector<Entity>* queue2; 
-	vector<Entity>* queue3; 
-	vector<Body>* queue4; 
-	vector<Surface>* queue5; 
-	vector<float>* sizeQueue2; 
-	vector<float>* sizeQueue3; 
-	vector<float>* sizeQueue4; 
-	vector<float>* sizeQueue5; 
-	vector<bool>* hboxQueue; 
-	vector<char>* animQueue;
-}; // Organizes the several render queues. queue1=background, queue2=backgroundobject, queue3=object, queue4=body, queue5=surface.
-
-struct LevelElement
-{
-	Entity* objptr;
-	char type; // E=Entity, D=Decoration, B=Body, S=Surface.
-	char animCode; // Dictates how (if at all) the object animates once rendered; this is primarily for obstacles. From a design perspective, having them animate brings attention to the fact that they can be interacted with or are potentially harmful. \0 (null char) = no animation, E=electrosphere, B=electro beam, F=initially-on flamethrower, G=initially-off flamethrower, M=missile, C=missile cannon, R=initially-off lightning, L=initially-on lightning,  K=key, H=health refill power-up. \0 returns false when passed as a bool.
-
-	pair<float,float> coordinates; // first=x, second=y.
-	pair<float,float> velocities; // first=x, second=y. Can only be nonzero if the element is a body or surface.
-	float size;
-	bool hitbox = false; // Only for Body instances.
-}; // For preparing the objects which need to be put into levels using the Level struct.
-
-struct Level
-{
-	float playerSize;
-	bool floor, ceiling, leftWall, rightWall;
-	bool doorLocked;
-
-	pair<Entity,Entity> backgrounds;
-	pair<float,float> playerLocation;
-	pair<float,float> doorLocation;
-	pair<float,float> cameraLocation; // If the camera is not in the level, this can simply be set to {-1000,-1000}.
-	pair<float,float> simulCameraLocation; // If the camera is not in the level, this can simply be set to {-1000,-1000}.
-	vector<LevelElement> elements;
-}; // Contains all the information about a level's objects and initial conditions.
-
-void loadLevel(Level l, Body& p, QueueSet& q, Entity& door, Entity& cam1, Entity& cam2) 
-{
-	clearEntities(q.queue5, q.sizeQueue5, q.animQueue);
-	clearEntities(q.queue4, q.sizeQueue4, q.hboxQueue);
-	clearEntities(q.queue3, q.sizeQueue3);
-	clearEntities(q.queue2, q.sizeQueue2);
-	q.queue1->clear();
-
-	p.setCoords(l.playerLocation.first, l.playerLocation.second);
-	q.queue1->push_back(l.backgrounds.first);
-	q.queue1->push_back(l.backgrounds.second);
-
-	door.setCoords(l.doorLocation.first, l.doorLocation.second);
-	displayEntity(q.queue3, q.sizeQueue3, door, 0.65);
-	cam1.setCoords(l.cameraLocation.first, l.cameraLocation.second);
-	displayEntity(q.queue3, q.sizeQueue3, cam1, 0.4);
-	cam2.setCoords(l.simulCameraLocation.first, l.simulCameraLocation.second);
-	displayEntity(q.queue3, q.sizeQueue3, cam2, 0.4);
-
-	for (LevelElement element : l.elements) {
-		Entity* e = element.objptr;
-		e->setCoords(element.elementX, element.elementY);
-		e->setXPrime(element.velocities.first);
-		e->setYPrime(element.velocities.second);
-
-		switch (element.type)
-		{
-			case 'S':
-			{
-				Surface* s = dynamic_cast<Surface*>(e);
-				displayEntity(q.queue5, q.sizeQueue5, q.animQueue, *s, element.size, element.animCode);
-				break;
-			}
-			case 'B': 
-			{
-				Body* b = dynamic_cast<Body*>(e);
-				displayEntity(q.queue4, q.sizeQueue4, q.hboxQueue, *b, element.size, element.hitbox);
-				break;
-			}
-			case 'D':
-			{
-				displayEntity(q.queue2, q.sizeQueue2, *e, element.size);
-				break;
-			}				
-			case 'E':
-			{
-				displayEntity(q.queue3, q.sizeQueue3, *e, element.size);
-				break;
-			}
-		}
-	}
-
-	p.jump(0);
-} // Sets up the objects in the levels to be rendered.
-
 // Constants
 
 const float PI = 3.14159265;
 const float EAST = 0, NORTH = PI / 2, WEST = PI, SOUTH = 3*PI / 2;
 const float NORTHEAST = PI / 4, NORTHWEST = 3*PI / 4, SOUTHWEST = 5*PI / 4, SOUTHEAST = 7*PI / 4;
 const int WINDOW_WIDTH = 1400, WINDOW_HEIGHT = 750;
+const int ABERRATION_QUALITY = Aberration::DEFAULT_COLUMNS; // Cells across the aberration mesh. Halve it on slow machines; past 64 there's nothing more to see.
 const pair<float,float> OFFSCREEN_COORDINATES = {-1000,-1000};
 const pair<float,float> CENTER = {WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2};
+const SDL_Rect SPLIT_LEFT = {0, WINDOW_HEIGHT / 4, WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2}, SPLIT_RIGHT = {WINDOW_WIDTH / 2, WINDOW_HEIGHT / 4, WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2}; // The two halves of the split screen, at half size so the level keeps its shape.
+const double CAMERA_DILATION = 90; // How much slower the train runs while watched from a camera, on top of gamma. At the game's speeds gamma alone is barely noticeable, so this is tuned to make the slowdown obvious.
+const int PHYSICS_STRIDE = 10; // Train ticks the level's bodies and surfaces are moved in one go, with velocity Verlet. The player, and whatever they're standing on, still move every tick.
+const float CONTACT_SKIN = 1.0; // The gap, in pixels, left between the player and whatever they collide with, so that resting contact doesn't count as overlap on the next tick.
+
+struct View
+{
+	bool relativity; // Seen from a camera, so doppler shifted and behind the lens.
+	bool delayed; // Drawn with the light delay, which is only worked out for the watching frame.
+	const RelativisticKinematics* lorentz; // Everything's contraction in this frame.
+	Uint8 redshift, blueshift;
+	float aberrationBeta;
+	SDL_Rect area; // Where it goes on the screen when there's more than one.
+}; // One frame of reference's picture of the level, for the object rendering section.
+
+struct Launcher
+{
+	float x, y;
+	float muzzle; // How far from x the missile comes out.
+	double tilt;
+	float direction; // The way the missile flies.
+}; // A missile launcher in the current level, as the LAUNCHER timers and the hazard scheduler fire it.
 
 int main(int argc, char* args[])
 {
+	if (argc > 1 && string(args[1]) == "--cook") {
+		int cooked = cookLevels(argc > 2 ? args[2] : "res/levels");
+		std::cout << "Cooked " << cooked << " levels.\n";
+		return cooked > 0 ? 0 : 1;
+	} // Running the game with --cook [directory] converts the level files to their binary form and exits without opening a window.
+	if (argc > 1 && string(args[1]) == "--benchmark")
+		return benchmarks::run(argc, args); // --benchmark [name ...] runs the headless benchmarks in benchmark.cpp.
+	if (argc > 1 && string(args[1]) == "--fixed-point")
+		Body::setFixedPoint(true); // Plays with the fixed-point physics, which comes out the same on every machine.
+
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) > 0)
 		std::cout << "SDL SYSTEM FAILURE. ERROR: " << SDL_GetError() << '\n';
 	if (!(IMG_Init(IMG_INIT_PNG)))
 		std::cout << "SDL IMAGE FAILURE. ERROR: " << SDL_GetError() << '\n';
 	if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
     	std::cout << "SDL AUDIO FAILURE. ERROR: " << Mix_GetError() << '\n';
+	DopplerAudio dopplerAudio; // Shifts the music and sound effects while watching from a camera.
+	dopplerAudio.attach();
 
     // Game handling variables
 
@@ -191,8 +116,12 @@ int main(int argc, char* args[])
 	int tickRate = 100000; // tickRate is in ticks per second. A "tick" is the shortest unit of in-game time.
 	int gameState = 2; // gameState dictates the player's degree of control based on what is being displayed - 0 indicates platforming/active gameplay, 1 indicates a cutscene during which the player cannot be controlled and may not be displayed, and 2 indicates the title screen.
 	int currentLevel = 0; // level = 0 means not in a level.
-	int targetTime[10]{};
 	int timer = 0; // Starts running immediately and never stops.
+	TimerWheel timers; // Advanced along with timer, but never reset, so gameplay timers can outlast a level restart.
+	TimerWheel::Fired fired;
+	enum GameTimer {INVULNERABILITY, CAMERA_TIMEOUT, SIMUL_CAMERA_TIMEOUT, TICKING, EXPLOSION, HEALTH_BAR, LENS_BLINK, BEAM_TOGGLE, ZAP, LAUNCHER, FLAME_BURST, FLAME_OUT};
+	TimerId invulnerability, cameraTimeout, simulCameraTimeout, ticking, healthBarShown, beamToggle;
+	vector<TimerId> levelTimers; // The current level's periodic hazards.
 	char titleLayer = 'T'; // T=title, P=play options, L=level select, C=controls, R=credits.
 	char cutsceneCode = 'N'; // N=none, O=opening cutscene, A=camera activation, D=camera deactivation, 1=time dilation tutorial, 2=length contraction tutorial, 3=relativity of simultaneity tutorial, E=ending cutscene.
 	bool nextLevel = false;
@@ -205,12 +134,12 @@ int main(int argc, char* args[])
 	int cutsceneTimer = 0;
 	float trainFrameDelay = 0.01;
 
-	float a = 10, b = 0;
 	int c = 3, d = 3; // For animation.
 
 	// Sprites and Entities
 
 	RenderWindow window("Untitled Relativity Game", WINDOW_WIDTH, WINDOW_HEIGHT);
+	window.setAberrationQuality(ABERRATION_QUALITY);
 
 	SDL_Texture* player = window.loadTexture("res/gfx/miscellaneous/pixelpic2.png"); // Not to be confused with thePlayer.
 	SDL_Texture* chalkboard = window.loadTexture("res/gfx/decoration/gamma.png");
@@ -522,6 +451,10 @@ int main(int argc, char* args[])
 	float platformBorderL = -1000, platformBorderR = 3000, platformBorderY = -1000; 
 	int landedIndex = -1;
 	char landedType = 'n'; // For none, while 'b' means body and 's' means surface.
+	float playerStartX, playerStartY, stepX, stepY; // Where the player was before this tick's move, and how much of the move is still to be resolved against what's in the way.
+	int hitIndex, hitSide;
+	char hitType; // Same as landedType.
+	float hitTime, hitContraction; // The earliest collision found this tick, as a fraction of the step.
 	int j = 0;
 
 	thePlayer.setCoords(600, 100);
@@ -569,6 +502,8 @@ int main(int argc, char* args[])
 
 	Surface exitKey(doorKey, false, false, false, false, 0);
 	Surface healthRefill(healthPowerup, false, false, false, 0);
+	exitKey.setTrigger();
+	healthRefill.setTrigger();
 	Surface flameThrowerAnimated(flameThrower, false, false, false, false, 1);
 	Surface electroSphereAnimated(electroSphere, false, false, false, false, 1);
 	Surface flameContainerR(flameBaseR, true, true, true, true, 0);
@@ -641,6 +576,17 @@ int main(int argc, char* args[])
 		&surfaceAnimationCode
 	};
 
+	SpatialGrid surfaceGrid, bodyGrid; // Broad phase for player collision. Synced from the body and surface queues before each use.
+	ContactList contacts; // What the player touched this tick and last, for the contact handlers after player collision.
+	ProximityIndex proximity; // What the player is near enough to interact with. The door and cameras are always the first three objects; see loadLevel().
+	const int DOOR_NEAR = proximity.add(&objectRenderQueue, 0, 220), DOOR_AT = proximity.add(&objectRenderQueue, 0, 50);
+	const int CAMERA = proximity.add(&objectRenderQueue, 1, 80), SIMUL_CAMERA = proximity.add(&objectRenderQueue, 2, 50);
+	const int CAMERA_LAPTOP = proximity.add(&cameraActivator, 250), SIMUL_CAMERA_LAPTOP = proximity.add(&simulCameraActivator, 250);
+	const int TUTORIAL = proximity.add(&objectRenderQueue, -1, 50); // Pointed at the tutorial hologram by the object loop, on the levels that have one.
+	Kinematics kinematics; // Moves the body and surface queues a stride at a time.
+	JobSystem jobs;
+	kinematics.setJobSystem(&jobs); // Only stress levels have queues big enough to be split up; the hand-made ones are still stepped on this thread.
+
 	displayEntity(&objectRenderQueue, &objectRenderSize, exitDoor, 0.65);
 	displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, platform1);
 	displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, platform2);
@@ -705,6 +651,25 @@ int main(int argc, char* args[])
 	soundEffects["Quit to Title"] = Mix_LoadWAV("res/sfx/sounds/quit to title.wav");
 	soundEffects["Tutorial"] = Mix_LoadWAV("res/sfx/sounds/mixkit-interface-hint-notification-911.wav");
 
+	VoiceManager voices; // Who gets a channel when too much is going on at once.
+	for (auto& sound : soundEffects)
+		voices.define(sound.first, sound.second, VoiceManager::ACTION);
+	voices.define("Hurt", soundEffects["Hurt"], VoiceManager::CRITICAL, 1);
+	voices.define("Game Over", soundEffects["Game Over"], VoiceManager::CRITICAL, 1);
+	voices.define("Level Complete", soundEffects["Level Complete"], VoiceManager::CRITICAL, 1);
+	voices.define("Restart", soundEffects["Restart"], VoiceManager::CRITICAL, 1);
+	voices.define("Quit to Title", soundEffects["Quit to Title"], VoiceManager::CRITICAL, 1);
+	voices.define("Ticking", soundEffects["Ticking"], VoiceManager::CUE, 1);
+	voices.define("Tutorial", soundEffects["Tutorial"], VoiceManager::CUE, 1);
+	voices.define("Jump", soundEffects["Jump"], VoiceManager::ACTION, 1);
+	voices.define("Missile Shot", soundEffects["Missile Shot"], VoiceManager::HAZARD, 3, 50);
+	voices.define("Zap", soundEffects["Zap"], VoiceManager::HAZARD, 2, 80);
+	voices.define("Lightning", soundEffects["Lightning"], VoiceManager::HAZARD, 2, 100);
+	voices.define("Flame Burst", soundEffects["Flame Burst"], VoiceManager::HAZARD, 2, 100);
+	voices.define("Space Ambience", soundEffects["Space Ambience"], VoiceManager::AMBIENT, 1);
+	voices.define("Indoor Ambience", soundEffects["Indoor Ambience"], VoiceManager::AMBIENT, 1);
+	voices.define("Train Noise", soundEffects["Train Noise"], VoiceManager::AMBIENT, 1); // Being told you were hit, or that the level's over, is never crowded out; the hazards' own sounds give way first, and the background before them.
+
 	int musicVolume = 16, soundVolume = 32; // These seem like good default volumes.
 
 	Mix_Volume(-1,soundVolume); 
@@ -716,455 +681,127 @@ int main(int argc, char* args[])
 	FrameOfReference camera = {false, 0.1*SPEED_OF_LIGHT};
 	FrameOfReference simulCamera = {false, -0.1*SPEED_OF_LIGHT};
 
-	bool relativityOn = false;
-	float gamma = lorentzFactor(train, camera); // Equal to 1.25 at the start of the game.
-	float playerLengthContraction = 1.0;// The factors by which spatial dimensions are contracted for the player. Other entities, if they move, are simply have their length divided by gamma.
-	Uint8 redshiftAmount = 0, blueshiftAmount = 0; // The magnitudes of the relativistic doppler effect.
-
-	// Levels 
-
-	LevelElement level1_lowPlatform = {&solidLongLong, 'S', '\0', {0,500}, {0,0}, 1.0};
-	LevelElement level1_highPlatform = {&solidLongLong, 'S', '\0', {600,300}, {0,0}, 1.0};
-	LevelElement level1_decoBoard = {&maxwellBoard, 'D', '\0', {583,40}, {0,0}, 0.55};
-	LevelElement level1_table = {&table, 'D', '\0', {1145,595}, {0,0}, 0.40};
-	LevelElement level1_potion1 = {&greenPotion, 'D', '\0', {1180,560}, {0,0}, 0.5};
-	LevelElement level1_potion2 = {&bluePotion, 'D', '\0', {1230,545}, {0,0}, 0.5};
-	LevelElement level1_potion3 = {&purplePotion, 'D', '\0', {1280,518}, {0,0}, 0.5};
-	LevelElement level1_beam1 = {&lsupportBeam, 'E', '\0', {50,500}, {0,0}, 0.5};
-	LevelElement level1_beam2 = {&rsupportBeam, 'E', '\0', {1350,300}, {0,0}, 0.5};
-	LevelElement level1_sign = {&sign1, 'D', '\0', {380,596}, {0,0}, 0.65};
-
-	Level level_1 = {
-		0.4, // playerSize
-		true, false, true, true, // implicit borders
-		false, // door locked
-		{backgroundc, backgroundc}, // backgrounds
-		{100, 560}, // player coordinates
-		{1255, 150}, // door coordinates
-		OFFSCREEN_COORDINATES, // camera coordinates
-		OFFSCREEN_COORDINATES, // simul camera coordinates
-		{level1_lowPlatform, level1_highPlatform, level1_decoBoard, level1_table, level1_potion1, level1_potion2, level1_potion3, level1_beam1, level1_beam2, level1_sign} // elements
-	};
-
-
-	LevelElement level2_bottomCrate = {&largeCrate, 'S', '\0', {440,510}, {0,0}, 0.6};
-	LevelElement level2_bottomCrate2 = {&largeCrate, 'S', '\0', {740,510}, {0,0}, 0.6};
-	LevelElement level2_topCrate = {&largeCrate, 'S', '\0', {580,330}, {0,0}, 0.6};
-	LevelElement level2_platform = {&solidShort, 'S', '\0', {200,330}, {-10,0}, 0.9};
-	LevelElement level2_decoBoard = {&lorentzBoard, 'D', '\0', {620,20}, {0,0}, 0.55};
-	LevelElement level2_key = {&exitKey, 'S', 'K', {50,60}, {0,0}, 0.55};
-	LevelElement level2_sign = {&sign2, 'D', '\0', {300,595}, {0,0}, 0.65};
-
-	Level level_2 = {
-		0.38, // playerSize
-		true, true, true, true, // implicit borders
-		true, // door locked
-		{backgrounda, backgroundb}, // backgrounds 
-		{60, 560}, // player coordinates
-		{1255, 544}, // door coordinates
-		OFFSCREEN_COORDINATES, // camera coordinates
-		OFFSCREEN_COORDINATES, // simul camera coordinates
-		{level2_bottomCrate, level2_bottomCrate2, level2_topCrate, level2_platform, level2_decoBoard, level2_key, level2_sign} // elements
-	};
-
-
-	LevelElement level3_leftPlatform = {&solidShort, 'S', '\0', {-35,200}, {0,0}, 1.0};
-	LevelElement level3_middlePlatform = {&solidLong, 'S', '\0', {400,200}, {0,0}, 1.0};
-	LevelElement level3_rightPlatform = {&solidShort, 'S', '\0', {1210,200}, {0,0}, 1.0};
-	LevelElement level3_lbeam1 = {&verticalSupportBeam, 'E', '\0', {35,240}, {0,0}, 1.3};
-	LevelElement level3_lbeam2 = {&verticalSupportBeam, 'E', '\0', {440,240}, {0,0}, 1.3};
-	LevelElement level3_lbeam3 = {&verticalSupportBeam, 'E', '\0', {750,240}, {0,0}, 1.3};
-	LevelElement level3_lbeam4 = {&verticalSupportBeam, 'E', '\0', {1290,240}, {0,0}, 1.3};
-	LevelElement level3_string1 = {&supportString, 'E', '\0', {530,240}, {0,0}, 0.22};
-	LevelElement level3_string2 = {&supportString, 'E', '\0', {690,240}, {0,0}, 0.22};
-	LevelElement level3_decoBoard = {&transformBoard, 'D', '\0', {500,357}, {0,0}, 0.56};
-	LevelElement level3_shade = {&shade, 'D', '\0', {0,350}, {0,0}, 2.0};
-	LevelElement level3_sign = {&sign3, 'D', '\0', {51,118}, {0,0}, 0.65};
-
-	Level level_3 = {
-		0.4, // playerSize
-		false, false, true, true, // implicit borders
-		false, // door locked
-		{backgroundd, backgroundd}, // backgrounds 
-		{60, 50}, // player coordinates
-		{1290, 50}, // door coordinates
-		OFFSCREEN_COORDINATES, // camera coordinates
-		OFFSCREEN_COORDINATES, // simul camera coordinates
-		{level3_leftPlatform, level3_middlePlatform, level3_rightPlatform, level3_lbeam1, level3_lbeam2, level3_lbeam3, level3_lbeam4, level3_string1, level3_string2, level3_decoBoard, level3_shade, level3_sign} // elements
-	};
-
-
-	LevelElement level4_key = {&exitKey, 'S', 'K', {1250,550}, {0,0}, 0.55};
-	LevelElement level4_ceiling = {&solidBlockR, 'S', '\0', {-20,-590}, {0,0}, 3.5};
-	LevelElement level4_platform = {&semisolidLong, 'S', '\0', {-90,330}, {0,0}, 1.0};
-	LevelElement level4_stair1 = {&semisolidShort, 'S', '\0', {260,380}, {0,0}, 1.0};
-	LevelElement level4_stair2 = {&semisolidShort, 'S', '\0', {350,430}, {0,0}, 1.0};
-	LevelElement level4_stair3 = {&semisolidShort, 'S', '\0', {440,480}, {0,0}, 1.0};
-	LevelElement level4_stair4 = {&semisolidShort, 'S', '\0', {530,530}, {0,0}, 1.0};
-	LevelElement level4_stair5 = {&semisolidShort, 'S', '\0', {620,580}, {0,0}, 1.0};
-	LevelElement level4_stair6 = {&semisolidShort, 'S', '\0', {710,630}, {0,0}, 1.0};
-	LevelElement level4_ceilingblock1 = {&solidBlock, 'S', '\0', {470,-150}, {0,0}, 1.75};
-	LevelElement level4_ceilingblock2 = {&solidBlock, 'S', '\0', {520,-30}, {0,0}, 1.5};
-	LevelElement level4_electrosphere = {&electroSphereAnimated, 'S', 'E', {760,180}, {0,0}, 0.5};
-	LevelElement level4_flamethrowerBottom = {&flameContainerU, 'S', '\0', {1080,696}, {0,0}, 1.0};
-	LevelElement level4_flamethrowerTop = {&flameContainerD, 'S', '\0', {170,0}, {0,0}, 1.0};
-	LevelElement level4_flameBottom = {&flameBurstU, 'S', 'F', {1085,460.5}, {0,0}, 0.88};
-	LevelElement level4_flameTop = {&flameBurstD, 'S', 'G', {184,100}, {0,0}, 0.88};
-	LevelElement level4_beam = level1_beam1; level4_beam.elementY -= 185;
-	LevelElement level4_decoBoard = {&logisticsBoard, 'D', '\0', {1202,220}, {0,0}, 0.44};
-	LevelElement level4_potion1 = level1_potion1; 
-	level4_potion1.elementY += 100; level4_potion1.elementX += 150;
-	LevelElement level4_potion2 = level1_potion2; 
-	level4_potion2.elementY += 100; level4_potion2.elementX += 140;
-	LevelElement level4_sign = {&sign4, 'D', '\0', {385,594}, {0,0}, 0.65};
-
-	Level level_4 = {
-		0.36, // playerSize
-		true, true, true, true, // implicit borders
-		true, // door locked
-		{backgrounda, backgroundb}, // backgrounds 
-		{60, 560}, // player coordinates
-		{60, 182.5}, // door coordinates
-		OFFSCREEN_COORDINATES, // camera coordinates
-		OFFSCREEN_COORDINATES, // simul camera coordinates
-		{level4_key, level4_electrosphere, level4_ceilingblock2, level4_ceilingblock1, level4_ceiling, level4_platform, level4_stair1, level4_stair2, level4_stair3, level4_stair4, level4_stair5, level4_stair6, level4_flamethrowerBottom, level4_flamethrowerTop, level4_flameBottom, level4_flameTop, level4_beam, level4_decoBoard, level4_potion1, level4_potion2, level4_sign} // elements
-	};
-
-
-	LevelElement level5_shade = level3_shade;
-	LevelElement level5_movingPlatform = {&solidPlatform, 'S', '\0', {225,170}, {0,7.5}, 0.8};
-	LevelElement level5_leftPlatform = {&solidPlatform, 'S', '\0', {-32,170}, {0,0}, 0.8};
-	LevelElement level5_rightPlatform = {&solidPlatform, 'S', '\0', {492,170}, {0,0}, 0.8};
-	LevelElement level5_bottomPlatform = {&solidLong, 'S', '\0', {560,680}, {0,0}, 1.0};
-	LevelElement level5_block1 = {&metalCrateTall, 'S', '\0', {713,0}, {0,0}, 0.7};
-	LevelElement level5_block2 = {&metalCrateTall, 'S', '\0', {1114,212.5}, {0,0}, 0.7};
-	LevelElement level5_tutorial = {&tutorialHolo, 'E', '\0', {68,47}, {0,0}, 0.50};
-	LevelElement level5_beam1 = {&rsupportBeam, 'E', '\0', {696,170}, {0,0}, 0.5};
-	LevelElement level5_verticalBeam = level3_lbeam4; level5_verticalBeam.elementX -= 95;
-	LevelElement level5_string1 = {&lsupportString, 'E', '\0', {690,400}, {0,0}, 0.6};
-	LevelElement level5_string2 = {&rsupportString, 'E', '\0', {910,400}, {0,0}, 0.6};
-	LevelElement level5_doorPlatform = level3_rightPlatform;
-	level5_doorPlatform.elementX += 35; level5_doorPlatform.elementY -= 5;
-	LevelElement level5_ledge1 = {&semisolidShort, 'S', '\0', {1031,549}, {0,0}, 1.0};
-	LevelElement level5_ledge2 = {&semisolidShort, 'S', '\0', {790,359}, {0,0}, 1.0};
-	LevelElement level5_electrobeam2 = {&elecBeam, 'S', 'B', {890,215}, {0,0}, 0.7};
-	LevelElement level5_electrobeam1 = {&elecBeam, 'S', 'B', {890,380}, {0,0}, 0.7};
-	LevelElement level5_lSupportBeam = {&lsupportBeam, 'E', '\0', {54,168}, {0,0}, 0.5};
-	LevelElement level5_decoBoard = {&invariantBoard, 'D', '\0', {260, 260}, {0,0}, 0.5};
-	LevelElement level5_sign = {&sign5, 'D', '\0', {500,80}, {0,0}, 0.65};
-
-	Level level_5 = {
-		0.35, // playerSize
-		false, true, true, true, // implicit borders
-		false, // door locked
-		{backgroundd, backgroundd}, // backgrounds 
-		{340, 50}, // player coordinates
-		{1313, 47}, // door coordinates
-		{607, 109}, // camera coordinates
-		OFFSCREEN_COORDINATES, // simul camera coordinates
-		{level5_electrobeam1, level5_electrobeam2, level5_ledge1, level5_ledge2, level5_lSupportBeam, level5_doorPlatform, level5_shade, level5_leftPlatform, level5_movingPlatform, level5_rightPlatform, level5_tutorial, level5_bottomPlatform, level5_block1, level5_block2, level5_beam1, level5_verticalBeam, level5_string1, level5_string2, level5_decoBoard, level5_sign} // elements
-	};
-
-
-	LevelElement level6_floatingPlatform = level5_leftPlatform;
-	level6_floatingPlatform.elementY += 100;
-	LevelElement level6_missilePlatform = level6_floatingPlatform;
-	level6_missilePlatform.elementX += 520;
-	LevelElement level6_centrePlatform = level6_missilePlatform;
-	level6_centrePlatform.elementY = 457; level6_centrePlatform.elementX += 10;
-	LevelElement level6_movingPlatform = level2_platform;
-	level6_movingPlatform.coordinates = {274,460}; level6_movingPlatform.size = 0.8; level6_movingPlatform.objptr = &semisolidShort;
-	level6_floatingPlatform.elementY += 10;
-	LevelElement level6_startingBlock = {&solidBlock, 'S', '\0', {-285,460}, {0,0}, 1.22};
-	LevelElement level6_pit = {&dmgPlatform, 'S', '\0', {170,642}, {0,0}, 1.06};
-	LevelElement level6_bottomWall = {&thinWall, 'S', '\0', {500,476}, {0,0}, 1};
-	LevelElement level6_topWall = {&thinWall, 'S', '\0', {722,-323}, {0,0}, 1};
-	LevelElement level6_otherBlock = {&solidBlock, 'S', '\0', {862,276}, {0,0}, 1.12};
-	LevelElement level6_risingPlatform = level6_movingPlatform;
-	level6_risingPlatform.elementX += 500; level6_risingPlatform.elementY -= 100; 
-	level6_risingPlatform.velocities = {0,6};
-	LevelElement level6_pit2 = {&dmgPlatform, 'S', '\0', {740,475}, {0,0}, 0.66};
-	LevelElement level6_flamethrower1 = {&flameContainerD, 'S', '\0', {944,406}, {0,0}, 1.0};
-	LevelElement level6_flame1 = {&flameBurstD, 'S', 'F', {960,506}, {0,0}, 0.88};
-	LevelElement level6_flamethrower2 = level6_flamethrower1; level6_flamethrower2.elementX += 100;
-	LevelElement level6_flame2 = level6_flame1; level6_flame2.elementX += 100;
-	LevelElement level6_flamethrower3 = level6_flamethrower2; level6_flamethrower3.elementX += 100;
-	LevelElement level6_flame3 = level6_flame2; level6_flame3.elementX += 100;
-	LevelElement level6_healthRefill = {&healthRefill, 'S', 'H', {30,180}, {0,0}, 0.5};
-	LevelElement level6_missileLauncher1 = {&missileCannon, 'S', 'C', {650,180}, {0,0}, 1};
-	LevelElement level6_missileLauncher2 = {&missileCannon, 'S', 'C', {1200,200}, {0,0}, 1};
-	LevelElement level6_decoBoard = {&phiBoard, 'D', '\0', {255,30}, {0,0}, 0.5};
-	LevelElement level6_sign = {&sign6, 'D', '\0', {145,368}, {0,0}, 0.65};
-
-	Level level_6 = {
-		0.36, // playerSize
-		true, false, true, true, // implicit borders
-		false, // door locked
-		{backgrounda, backgroundb}, // backgrounds 
-		{60, 360}, // player coordinates
-		{600, 544}, // door coordinates
-		{597, 408}, // camera coordinates
-		OFFSCREEN_COORDINATES, // simul camera coordinates
-		{level6_missileLauncher2, level6_missileLauncher1, level6_flamethrower1, level6_flame1, level6_flamethrower2, level6_flame2, level6_flamethrower3, level6_flame3, level6_risingPlatform, level6_pit, level6_startingBlock, level6_startingBlock, level6_floatingPlatform, level6_missilePlatform, level6_centrePlatform, level6_movingPlatform, level6_bottomWall, level6_topWall, level6_pit2, level6_otherBlock, level6_healthRefill, level6_decoBoard, level6_sign} // elements
-	};
-
-
-	LevelElement level7_block1 = {&solidBlock, 'S', '\0', {935,380}, {0,0}, 1};
-	LevelElement level7_block2 = {&solidBlock, 'S', '\0', {330,380}, {0,0}, 1};
-	LevelElement level7_topPlatform1 = {&semisolidLong, 'S', '\0', {450,100}, {0,0}, 0.7};
-	LevelElement level7_topPlatform2 = {&semisolidLong, 'S', '\0', {50,100}, {0,0}, 0.7};
-	LevelElement level7_ladder1 = {&semisolidShort, 'S', '\0', {1270,510}, {0,0}, 1.0};
-	LevelElement level7_ladder2 = level7_ladder1; 
-	LevelElement level7_middlePlatform = {&semisolidPlatform, 'S', '\0', {694,385}, {0,0}, 0.85};
-	LevelElement level7_redPlatform1 = {&dmgPlatform, 'S', '\0', {120,200}, {6,0}, 0.76};
-	LevelElement level7_redPlatform2 = level7_redPlatform1; level7_redPlatform2.velocities.first *= -1;
-	level7_redPlatform2.elementX += 320;
-	level7_ladder1.elementY -= 120;
-	LevelElement level7_smallPlatform = {&semisolidShort, 'S', '\0', {356,217}, {0,0}, 0.5};
-	LevelElement level7_doorPlatform = {&blueSolidPlatform, 'S', '\0', {930,150}, {0,0}, 0.75};
-	LevelElement level7_beam1 = {&verticalSupportBeam, 'E', '\0', {410,380}, {0,0}, 0.77};
-	LevelElement level7_beam2 = {&verticalSupportBeam, 'E', '\0', {650,380}, {0,0}, 0.77};
-	LevelElement level7_beam3 = {&verticalSupportBeam, 'E', '\0', {1000,380}, {0,0}, 0.77};
-	LevelElement level7_beam4 = {&verticalSupportBeam, 'E', '\0', {1250,380}, {0,0}, 0.77};
-	LevelElement level7_beam5 = {&verticalSupportBeam, 'E', '\0', {1050,150}, {0,0}, 0.9};
-	LevelElement level7_beam6 = {&verticalSupportBeam, 'E', '\0', {396,236}, {0,0}, 0.6};
-	LevelElement level7_electrosphere = {&electroSphereAnimated, 'S', 'E', {160,10}, {0,0}, 0.4};
-	LevelElement level7_string1 = {&supportString, 'E', '\0', {110,-40}, {0,0}, 0.32};
-	LevelElement level7_string2 = {&supportString, 'E', '\0', {320,-40}, {0,0}, 0.32};
-	LevelElement level7_string3 = {&supportString, 'E', '\0', {520,-40}, {0,0}, 0.32};
-	LevelElement level7_string4 = {&supportString, 'E', '\0', {710,-40}, {0,0}, 0.32};
-	LevelElement level7_tutorial = {&tutorialHolo, 'E', '\0', {480,590}, {0,0}, 0.50};
-	LevelElement level7_decoBoard = {&einsteinBoard, 'D', '\0', {749,430}, {0,0}, 0.45};
-	LevelElement level7_shelf = {&tabletop, 'D', '\0', {259.5,460}, {0,0}, 0.6};
-	LevelElement level7_potion = {&bluePotion, 'D', '\0', {273,410}, {0,0}, 0.5};
-	LevelElement level7_potion2 = {&purplePotion, 'D', '\0', {303,390}, {0,0}, 0.45};
-	LevelElement level7_sign = {&sign7, 'D', '\0', {278,595}, {0,0}, 0.65};
-
-	Level level_7 = {
-		0.33, // playerSize
-		true, false, true, true, // implicit borders
-		false, // door locked
-		{backgroundc, backgroundc}, // backgrounds 
-		{60, 560}, // player coordinates
-		{1025, 0}, // door coordinates
-		{1090, 642}, // camera coordinates
-		OFFSCREEN_COORDINATES, // simul camera coordinates
-		{level7_shelf, level7_electrosphere, level7_beam1, level7_beam2, level7_beam3, level7_beam4, level7_beam5, level7_beam6, level7_smallPlatform, level7_ladder1, level7_ladder2, level7_middlePlatform, level7_block1, level7_block2, level7_topPlatform1, level7_topPlatform2, level7_redPlatform1, level7_redPlatform2, level7_doorPlatform, level7_string1, level7_string2, level7_string3, level7_string4, level7_tutorial, level7_decoBoard, level7_potion, level7_potion2, level7_sign} // elements
-	};
-
-
-	LevelElement level8_shade = level3_shade;
-	LevelElement level8_electrosphere1 = {&electroSphereAnimated, 'S', 'E', {330,315}, {0,0}, 0.45};
-	LevelElement level8_flamethrower1 = {&flameContainerD, 'S', '\0', {350,-50}, {0,0}, 1.0};
-	LevelElement level8_flame1 = {&flameBurstD, 'S', 'F', {364,50}, {0,0}, 0.88};
-	LevelElement level8_flamethrower2 = level8_flamethrower1;
-	level8_flamethrower2.elementX += 650;
-	LevelElement level8_flame2 = level8_flame1;
-	level8_flame2.elementX += 650; level8_flame2.animCode = 'G';
-	LevelElement level8_platform1 = {&semisolidPlatform, 'S', '\0', {30,200}, {0,7}, 0.8};
-	LevelElement level8_platform2 = {&semisolidPlatform, 'S', '\0', {470,550}, {0,-7}, 0.8};
-	LevelElement level8_platform3 = level8_platform1;
-	level8_platform3.elementX += 700;
-	LevelElement level8_platform4 = {&semisolidShort, 'S', '\0', {1050,550}, {0,-7}, 0.8};
-	LevelElement level8_platform5 = {&semisolidShort, 'S', '\0', {1230,200}, {0,7}, 0.8};
-	LevelElement level8_electrosphere2 = level8_electrosphere1;
-	level8_electrosphere2.elementX = 960;
-	LevelElement level8_beam = level7_beam1;
-	level8_beam.coordinates = {592.5,545};
-	LevelElement level8_healthRefill = level6_healthRefill;
-	level8_healthRefill.coordinates = {712,612};
-	LevelElement level8_hiddenPlatform = {&semisolidShort, 'S', '\0', {652,750}, {0,0}, 1.0};
-	LevelElement level8_decoBoard = {&sourceCodeBoard, 'D', '\0', {595,27}, {0,0}, 0.6};
-	LevelElement level8_sign = {&sign8, 'D', '\0', {35,659}, {0,0}, 0.65};
-
-	Level level_8 = {
-		0.38, // playerSize
-		false, false, true, true, // implicit borders
-		false, // door locked
-		{backgrounda, backgrounde}, // backgrounds 
-		{70, 50}, // player coordinates
-		{1290, 65}, // door coordinates
-		{550, 480}, // camera coordinates
-		OFFSCREEN_COORDINATES, // simul camera coordinates
-		{level8_electrosphere1, level8_electrosphere2, level8_flamethrower1, level8_flame1, level8_flamethrower2, level8_flame2, level8_platform1, level8_platform2, level8_platform3, level8_platform4, level8_platform5, level8_beam, level8_healthRefill, level8_hiddenPlatform, level8_decoBoard, level8_shade, level8_sign} // elements
-	};
-
-
-	LevelElement level9_shade = level8_shade;
-	LevelElement level9_missileLauncher1 = {&missileCannon, 'S', 'C', {1176,47}, {0,0}, 1};
-	LevelElement level9_missileLauncher2 = {&missileCannon, 'S', 'C', {160,380}, {0,0}, 1};
-	LevelElement level9_missileLauncher3 = {&missileCannon, 'S', 'C', {1176,607}, {0,0}, 1};
-	LevelElement level9_startingBlock = {&solidBlock, 'S', '\0', {-600,130}, {0,0}, 2};
-	LevelElement level9_topBlock = {&solidBlock, 'S', '\0', {1200,-182}, {0,0}, 2};
-	LevelElement level9_bottomBlock = {&solidBlock, 'S', '\0', {1200,522}, {0,0}, 2};
-	LevelElement level9_topPlatform = {&semisolidPlatform, 'S', '\0', {925,150}, {20,0}, 0.8};
-	LevelElement level9_bottomPlatform = {&semisolidPlatform, 'S', '\0', {325,500}, {-20,0}, 0.8};
-	LevelElement level9_bridge1 = level1_lowPlatform;
-	level9_bridge1.coordinates = {-30,680}; level9_bridge1.size = 0.5;
-	LevelElement level9_bridge2 = level9_bridge1;
-	level9_bridge2.elementX += 350;
-	LevelElement level9_bridge3 = level9_bridge2;
-	level9_bridge3.elementX += 350;
-	LevelElement level9_bridge4 = level9_bridge3;
-	level9_bridge4.elementX += 350;
-	LevelElement level9_ledge = level9_bridge1;
-	level9_ledge.coordinates = {-50,311};
-	LevelElement level9_key = level2_key;
-	level9_key.coordinates = {1020,-70};
-	LevelElement level9_beam1 = {&verticalSupportBeam, 'E', '\0', {235,680}, {0,0}, 0.77};
-	LevelElement level9_beam2 = {&verticalSupportBeam, 'E', '\0', {585,680}, {0,0}, 0.77};
-	LevelElement level9_beam3 = {&verticalSupportBeam, 'E', '\0', {935,680}, {0,0}, 0.77};
-	LevelElement level9_decoBoard = {&keyBoard, 'D', '\0', {915,27}, {0,0}, 0.4};
-	LevelElement level9_sign = {&sign9, 'D', '\0', {156,35}, {0,0}, 0.65};
-
-	Level level_9 = {
-		0.34, // playerSize
-		false, false, true, true, // implicit borders
-		true, // door locked
-		{backgroundd, backgroundd}, // backgrounds 
-		{40, 10}, // player coordinates
-		{1280, 372}, // door coordinates
-		{63, 622}, // camera coordinates
-		OFFSCREEN_COORDINATES, // simul camera coordinates
-		{level9_beam1, level9_beam2, level9_beam3, level9_ledge, level9_bridge1, level9_bridge2, level9_bridge3, level9_bridge4, level9_missileLauncher1, level9_missileLauncher2, level9_missileLauncher3, level9_startingBlock, level9_topBlock, level9_bottomBlock, level9_shade, level9_topPlatform, level9_bottomPlatform, level9_key, level9_decoBoard, level9_sign} // elements
-	};
-
-
-	LevelElement level10_crate = level2_topCrate;
-	level10_crate.size += 0.4; level10_crate.elementX -= 120; level10_crate.elementY += 250;
-	LevelElement level10_platform1 = {&semisolidShort, 'S', '\0', {10,600}, {0,-7}, 0.8};
-	LevelElement level10_platform2 = {&semisolidShort, 'S', '\0', {1210,200}, {0,7}, 0.8};
-	LevelElement level10_platform3 = {&semisolidShort, 'S', '\0', {700,175}, {30,0}, 0.8};
-	LevelElement level10_tutorial = level7_tutorial;
-	level10_tutorial.coordinates = {850,460};
-	LevelElement level10_leftLightning1 = {&lightningBeam, 'S', 'L', {200,-20}, {0,0}, 1.9};
-	LevelElement level10_leftLightning2 = {&lightningBeam, 'S', 'R', {200,-20}, {0,0}, 1.9};
-	LevelElement level10_rightLightning1 = {&lightningBeam, 'S', 'L', {1070,-20}, {0,0}, 1.9};
-	LevelElement level10_rightLightning2 = {&lightningBeam, 'S', 'R', {1070,-20}, {0,0}, 1.9};
-	LevelElement level10_decoBoard = {&simulBoard, 'D', '\0', {595,194}, {0,0}, 0.6};
-	LevelElement level10_sign = {&sign10, 'D', '\0', {655,490}, {0,0}, 0.65};
-
-	Level level_10 = {
-		0.38, // playerSize
-		true, false, true, true, // implicit borders
-		false, // door locked
-		{backgrounda, backgroundb}, // backgrounds 
-		{700, 460}, // player coordinates
-		{678, 28}, // door coordinates
-		OFFSCREEN_COORDINATES, // camera coordinates
-		{489, 517}, // simul camera coordinates
-		{level10_crate, level10_platform1, level10_platform2, level10_platform3, level10_tutorial, level10_leftLightning1, level10_leftLightning2, level10_rightLightning1, level10_rightLightning2, level10_decoBoard, level10_sign} // elements
-	};
-
-
-	LevelElement level11_ceiling1 = level4_ceiling;
-	LevelElement level11_ceiling2 = level11_ceiling1;
-	level11_ceiling1.elementX -= 1100;
-	level11_ceiling2.elementX += 1100;
-	LevelElement level11_lowCeiling1 = level11_ceiling1;
-	LevelElement level11_lowCeiling2 = level11_ceiling2;
-	level11_lowCeiling1.elementX -= 200; level11_lowCeiling1.elementY += 100;
-	level11_lowCeiling2.elementX += 200; level11_lowCeiling2.elementY += 100;
-	LevelElement level11_floor1 = {&solidBlock, 'S', '\0', {-1118,650}, {0,0}, 3.5};
-	LevelElement level11_floor2 = {&solidBlock, 'S', '\0', {1083,650}, {0,0}, 3.5};
-	LevelElement level11_highFloor1 = level11_floor1;
-	LevelElement level11_highFloor2 = level11_floor2;
-	level11_highFloor1.elementX -= 200; level11_highFloor1.elementY -= 100;
-	level11_highFloor2.elementX += 200; level11_highFloor2.elementY -= 100;
-	level11_floor2.elementX += 350;
-	level11_highFloor2.elementX -= 95;
-	LevelElement level11_cameraString = {&supportString, 'E', '\0', {273,-4}, {0,0}, 0.22};
-	LevelElement level11_electrosphere1 = {&electroSphereAnimated, 'S', 'E', {300,-7}, {0,0}, 0.3};
-	LevelElement level11_electrosphere2 = {&electroSphereAnimated, 'S', 'E', {1040,-7}, {0,0}, 0.3};
-	LevelElement level11_electrobeam1 = {&elecBeamLong, 'S', 'B', {380,30}, {0,0}, 0.696};
-	LevelElement level11_missileLauncher1 = {&missileCannon, 'S', 'C', {531,692}, {0,0}, 1};
-	LevelElement level11_missileLauncher2 = {&missileCannon, 'S', 'C', {842,692}, {0,0}, 1};
-	LevelElement level11_healthRefill = level6_healthRefill;
-	level11_healthRefill.coordinates = {844,600}; level11_healthRefill.size -= 0.1;
-	LevelElement level11_platform1 = {&solidShort, 'S', '\0', {360,330}, {0,15}, 0.8};
-	LevelElement level11_platform2 = level11_platform1;
-	level11_platform2.elementX += 300; level11_platform2.elementY -= 25;
-	LevelElement level11_decoBoard = {&brakeBoard, 'D', '\0', {246,288}, {0,0}, 0.65};
-	LevelElement level11_sign = {&sign11, 'D', '\0', {75,450}, {0,0}, 0.65};
-	LevelElement level11_shade = level3_shade;
-
-	Level level_11 = {
-		0.34, // playerSize
-		false, false, true, true, // implicit borders
-		false, // door locked
-		{backgroundd, backgroundd}, // backgrounds 
-		{39, 393}, // player coordinates
-		{1310, 400}, // door coordinates
-		{222, 586.5}, // camera coordinates
-		{222, 112}, // simul camera coordinates
-		{level11_cameraString, level11_electrobeam1, level11_electrosphere1, level11_electrosphere2, level11_lowCeiling1, level11_lowCeiling2, level11_ceiling1, level11_ceiling2, level11_highFloor1, level11_highFloor2, level11_floor1, level11_floor2, level11_missileLauncher1, level11_missileLauncher2, level11_healthRefill, level11_platform1, level11_platform2, level11_decoBoard, level11_shade, level11_sign} // elements
-	};
-
-
-	LevelElement level12_shade = level3_shade;
-	LevelElement level12_startingBlock = {&solidBlock, 'S', '\0', {-1320,135}, {0,0}, 3.5};
-	LevelElement level12_floatingBlock = {&solidBlock, 'S', '\0', {375,135}, {0,0}, 1.1};
-	LevelElement level12_blockSupport = level12_floatingBlock;
-	level12_blockSupport.elementY += 170;
-	LevelElement level12_ledge1 = {&semisolidPlatform, 'S', '\0', {660,475}, {0,0}, 0.8};
-	LevelElement level12_ledge2 = {&blueSolidPlatform, 'S', '\0', {1200,192}, {0,0}, 0.75};
-	LevelElement level12_flamethrowerLeft = {&flameContainerU, 'S', '\0', {390,121}, {0,0}, 1.0};
-	LevelElement level12_flameLeft = {&flameBurstU, 'S', 'F', {level12_flamethrowerLeft.elementX+5,level12_flamethrowerLeft.elementY-235.5}, {0,0}, 0.88};
-	LevelElement level12_flamethrowerRight = level12_flamethrowerLeft;
-	level12_flamethrowerRight.elementX += 330;
-	LevelElement level12_flameRight = level12_flameLeft;
-	level12_flameRight.elementX += 330;
-	LevelElement level12_lowPlatform = {&semisolidPlatform, 'S', '\0', {400,640}, {-10,0}, 0.87};
-	LevelElement level12_verticalPlatform1 = {&semisolidShort, 'S', '\0', {975,170}, {0,-9.5}, 0.75};
-	LevelElement level12_verticalPlatform2 = {&semisolidShort, 'S', '\0', {1215,590}, {0,9.5}, 0.75};
-	LevelElement level12_key = level2_key;
-	level12_key.coordinates = {1250,340};
-	LevelElement level12_electrosphere1 = level11_electrosphere1;
-	level12_electrosphere1.coordinates = {1360,300};
-	LevelElement level12_electrosphere2 = level12_electrosphere1;
-	level12_electrosphere2.elementY += 340;
-	LevelElement level12_leftSupportBeam = level1_beam1;
-	level12_leftSupportBeam.elementX += 740; level12_leftSupportBeam.elementY -= 30;
-	LevelElement level12_rightSupportBeam = level1_beam2;
-	level12_rightSupportBeam.elementY -= 120; level12_rightSupportBeam.elementX += 15;
-	LevelElement level12_lowerSupportBeam = level12_leftSupportBeam;
-	level12_lowerSupportBeam.elementX -= 130; level12_lowerSupportBeam.elementY += 130;
-	LevelElement level12_verticalBeam1 = {&verticalSupportBeam, 'E', '\0', {410,380}, {0,0}, 0.89};
-	LevelElement level12_verticalBeam2 = {&verticalSupportBeam, 'E', '\0', {410+185,380}, {0,0}, 0.89};
-	LevelElement level12_verticalBeam3 = {&verticalSupportBeam, 'E', '\0', {410+2*185,380}, {0,0}, 0.89};
-	LevelElement level12_leftLightning1 = level10_leftLightning1;
-	LevelElement level12_leftLightning2 = level10_leftLightning2;
-	LevelElement level12_rightLightning1 = level10_rightLightning1;
-	LevelElement level12_rightLightning2 = level10_rightLightning2;
-	level12_leftLightning1.elementY -= 150; level12_leftLightning1.elementX += 70; level12_leftLightning1.size -= 0.7;
-	level12_leftLightning2.elementY -= 150; level12_leftLightning2.elementX += 70; level12_leftLightning2.size -= 0.7;
-	level12_rightLightning1.elementY -= 0; level12_rightLightning1.elementX += 60; level12_rightLightning1.size -= 0.3;
-	level12_rightLightning2.elementY -= 0; level12_rightLightning2.elementX += 60; level12_rightLightning2.size -= 0.3;
-	LevelElement level12_supportString = {&supportString, 'E', '\0', {508,463}, {0,0}, 0.22};
-	LevelElement level12_potion = {&bluePotion, 'D', '\0', {497,85}, {0,0}, 0.5};
-	LevelElement level12_potion2 = {&purplePotion, 'D', '\0', {527,65}, {0,0}, 0.45};
-	LevelElement level12_decoBoard = {&generalBoard, 'D', '\0', {942,33.3}, {0,0}, 0.57};
-	LevelElement level12_sign = {&sign12, 'D', '\0', {36,34}, {0,0}, 0.65};
-
-	Level level_12 = {
-		0.35, // playerSize
-		false, false, true, true, // implicit borders
-		true, // door locked
-		{backgrounda, backgrounde}, // backgrounds 
-		{10,30}, // player coordinates
-		{1270, 47}, // door coordinates
-		{455, 579}, // camera coordinates
-		{575, 73}, // simul camera coordinates
-		{level12_supportString, level12_verticalBeam1, level12_verticalBeam2, level12_verticalBeam3, level12_lowerSupportBeam, level12_leftSupportBeam, level12_rightSupportBeam, level12_ledge1, level12_ledge2, level12_flamethrowerLeft, level12_flameLeft, level12_flamethrowerRight, level12_flameRight, level12_startingBlock, level12_floatingBlock, level12_blockSupport, level12_lowPlatform, level12_verticalPlatform1, level12_verticalPlatform2, level12_electrosphere1, level12_electrosphere2, level12_leftLightning1, level12_leftLightning2, level12_rightLightning1, level12_rightLightning2, level12_key, level12_decoBoard, level12_potion, level12_potion2, level12_shade, level12_sign} // elements
-	};
+	RelativityEngine relativityEngine;
+	RelativisticKinematics lorentz; // Each entity's length contraction and time dilation in whichever frame the player is watching from.
+	LightDelay lightDelay; // Where moving things were when the light now reaching the observer left them.
+	bool lightDelayOn = false; // Toggled with L.
+	EventScheduler hazards; // The lightning and level 11's missiles, which go off at set times on the train and so at other times in the cameras' frames.
+	EventScheduler::Due hazard;
+	enum HazardEvent {LIGHTNING_STRIKE, LIGHTNING_END, MISSILE_LAUNCH};
+	bool hazardsLoaded = false; // Cleared whenever a level is (re)loaded, so its hazards are read off the new queues.
+	const FrameOfReference* hazardFrame = nullptr; // The frame the hazards are currently scheduled in.
+	double hazardGamma = 1; // Its gamma relative to the train.
+	double hazardTime = 0; // The time in that frame, found from the train's clock so the hazards stay in step with the timer wheel.
+	int levelStart = 0; // The wheel's time when the current level was started. Its hazards are phased from here, so every level starts at the beginning of their cycles. Hot reloads leave it alone, so a reloaded level stays in step.
+	map<int,double> lightningStruck; // When each lightning beam last struck, by instance id.
+	map<int,Launcher> launchers; // The current level's missileLauncherN elements, by N. Looked up when the level loads, not every time one fires.
 
+	bool relativityOn = false;
+	const FrameOfReference* watching = &train; // The frame the player is watching from. timer counts its time.
+	int trainTicks = 1; // How many ticks the train's clock got through this tick. The level, player included, is on the train, so it only moves on these.
+	double levelTime = 0; // The train's time, as the clocks of the level's bodies keep it.
+	int strideTicks = 0; // Train ticks since the level was last moved.
+	float levelStep = 0; // How far in time the level was moved this tick, or 0 if it wasn't.
+	float playerContraction = 1.0; // This tick's lorentz.contraction(thePlayer), worked out once for collision and rendering to share. Other entities' factors are kept by lorentz.
+	RelativisticKinematics splitLorentz; // The factors for the half of the split screen that isn't the watching frame.
+	bool splitView = false; // Toggled with V.
+	View views[2] = {{false, true, &lorentz, 0, 0, 0, SPLIT_LEFT}, {false, false, &splitLorentz, 0, 0, 0, SPLIT_RIGHT}}; // The watching frame's first. Only it is drawn, unless splitView.
+	int viewCount = 1;
+
+	// Levels
+
+	const PrototypeRegistry prototypes = {
+		{"backgrounda", &backgrounda}, {"backgroundb", &backgroundb}, {"backgroundc", &backgroundc}, {"backgroundd", &backgroundd}, {"backgrounde", &backgrounde},
+		{"solidShort", &solidShort}, {"semisolidShort", &semisolidShort}, {"solidPlatform", &solidPlatform}, {"semisolidPlatform", &semisolidPlatform}, {"solidLong", &solidLong}, {"semisolidLong", &semisolidLong}, {"solidLongLong", &solidLongLong}, {"blueSolidPlatform", &blueSolidPlatform}, {"dmgPlatform", &dmgPlatform},
+		{"largeCrate", &largeCrate}, {"solidBlock", &solidBlock}, {"solidBlockR", &solidBlockR}, {"solidBlockRL", &solidBlockRL}, {"metalCrate", &metalCrate}, {"metalCrateWide", &metalCrateWide}, {"metalCrateTall", &metalCrateTall}, {"thinWall", &thinWall},
+		{"exitKey", &exitKey}, {"healthRefill", &healthRefill}, {"electroSphereAnimated", &electroSphereAnimated}, {"missileCannon", &missileCannon}, {"missile", &missile}, {"movingBody", &movingBody}, {"lightningBeam", &lightningBeam}, {"elecBeamShort", &elecBeamShort}, {"elecBeam", &elecBeam}, {"elecBeamLong", &elecBeamLong},
+		{"flameContainerR", &flameContainerR}, {"flameContainerD", &flameContainerD}, {"flameContainerL", &flameContainerL}, {"flameContainerU", &flameContainerU}, {"flameBurstR", &flameBurstR}, {"flameBurstD", &flameBurstD}, {"flameBurstL", &flameBurstL}, {"flameBurstU", &flameBurstU},
+		{"shortSupportBeam", &shortSupportBeam}, {"lsupportBeam", &lsupportBeam}, {"rsupportBeam", &rsupportBeam}, {"longSupportBeam", &longSupportBeam}, {"verticalSupportBeam", &verticalSupportBeam}, {"supportString", &supportString}, {"lsupportString", &lsupportString}, {"rsupportString", &rsupportString},
+		{"tutorialHolo", &tutorialHolo}, {"table", &table}, {"tabletop", &tabletop}, {"greenPotion", &greenPotion}, {"bluePotion", &bluePotion}, {"purplePotion", &purplePotion}, {"shade", &shade},
+		{"maxwellBoard", &maxwellBoard}, {"lorentzBoard", &lorentzBoard}, {"transformBoard", &transformBoard}, {"logisticsBoard", &logisticsBoard}, {"sourceCodeBoard", &sourceCodeBoard}, {"einsteinBoard", &einsteinBoard}, {"generalBoard", &generalBoard}, {"invariantBoard", &invariantBoard}, {"simulBoard", &simulBoard}, {"brakeBoard", &brakeBoard}, {"phiBoard", &phiBoard}, {"keyBoard", &keyBoard},
+		{"sign1", &sign1}, {"sign2", &sign2}, {"sign3", &sign3}, {"sign4", &sign4}, {"sign5", &sign5}, {"sign6", &sign6}, {"sign7", &sign7}, {"sign8", &sign8}, {"sign9", &sign9}, {"sign10", &sign10}, {"sign11", &sign11}, {"sign12", &sign12}
+	}; // The names that level files may use for backgrounds and element prototypes.
+
+	vector<Level> levelArray;
+	if (loadLevels("res/levels", prototypes, levelArray) == 0)
+		std::cout << "No levels could be loaded from res/levels.\n"; // The levels are read from res/levels/level1, level2, ... so adding a level only means adding a file.
+	LevelWatcher levelWatcher("res/levels"); // Lets level files be edited while the game is running.
+
+	auto startLevel = [&](int n) {
+		const Level& level = levelArray[n-1];
+		if (!loadLevel(level, thePlayer, renderQueues, exitDoor, cameraActivator, simulCameraActivator))
+			return false;
+		currentLevel = n;
+
+		if (level.floor)
+			displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, floorInvis);
+		if (level.ceiling)
+			displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, ceilingInvis);
+		if (level.leftWall)
+			displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, wallL);
+		if (level.rightWall)
+			displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, wallR);
+		objectRenderQueue[0].setTexture(door[level.doorLocked ? 0 : 1]);
+
+		playerSize = level.playerSize;
+		grounded = false;
+		facing = true;
+		thePlayer.setWidth(playerWidth[3]);
+		thePlayer.setHeight(playerHeight[3]);
+		thePlayer.setTexture(playerWalk[3]);
+		iFrame = false;
+		resetTransparency(thePlayer);
+		for (int i = 0; i < 10; i++) {
+			SDL_SetTextureAlphaMod(playerWalk[i], 255);
+		}
 
-	Level levelArray[12] = {level_1, level_2, level_3, level_4, level_5, level_6, level_7, level_8, level_9, level_10, level_11, level_12};
+		touchingPlatform = false;
+		exitDoorOpen = false;
+		platformBorderL = -1000;
+		platformBorderR = 3000;
+		platformBorderY = -1000;
+		landedIndex = -1;
+		landedType = 'n';
+		contacts.clear();
+		proximity.reset();
+		hazardsLoaded = false;
+		timer = 0;
+
+		relativityOn = false;
+		train.playerInFrame = true;
+		camera.playerInFrame = false;
+		simulCamera.playerInFrame = false;
+		timers.clear();
+		levelStart = timers.now();
+		return true;
+	}; // Puts level n in the queues and resets everything the last one, or the title screen, left behind, including the timers still pending from it. Used by the next door, new game and level select alike.
 
 	// Main loop
 	
 	while (running) 
 	{
+		voices.update();
+		watching = relativityOn ? (camera.playerInFrame ? &camera : &simulCamera) : &train;
+		trainTicks = relativityEngine.advance(train, *watching, relativityOn ? 1.0/CAMERA_DILATION : 1);
+		relativityEngine.advance(camera, *watching);
+		relativityEngine.advance(simulCamera, *watching); // Time dilation. Seen from a camera, the train's clock runs slow by gamma, and by CAMERA_DILATION more so it can be seen.
+
+		if (timer%100 == 0 && levelWatcher.changed()) {
+			for (unsigned int n = 0; n < levelArray.size(); n++) {
+				Level edited;
+				if (!loadLevelFile("res/levels/level" + std::to_string(n+1), prototypes, edited))
+					continue; // A half-saved or broken file leaves the old version of the level in place.
+
+				if (gameState != 2 && int(n) == currentLevel-1 && patchLevel(levelArray[n], edited, renderQueues) > 0) {
+					landedIndex = -1;
+					landedType = 'n';
+					contacts.clear();
+					proximity.reset();
+					hazardsLoaded = false;
+				} // The patched queues may have shifted, so the player finds the platform they're on and whatever else they're touching again next tick.
+				levelArray[n] = edited;
+			}
+		} // Hot reload. Only the level being played is patched; the rest are simply replaced and take effect the next time they're loaded.
 
 		switch(gameState)
 		{
@@ -1189,45 +826,42 @@ int main(int argc, char* args[])
 							if (event.key.repeat == 1)
 								break;
 
-							for (unsigned int i = 0; i < bodyRenderQueue.size(); i++) {
-								if (touching(thePlayer, theBody)) {
-									touchingPlatform = true;
-									break;
-								} else {
-									touchingPlatform = false;
-								}
-							}
-
-							if (!touchingPlatform) {
-								for (unsigned int i = 0; i < surfaceRenderQueue.size(); i++) {
-									if (touching(thePlayer, theSurface)) {
+							{
+								SDL_Rect feet = {static_cast<int>(thePlayer.getX()), static_cast<int>(thePlayer.getY() + thePlayer.getHeight()*thePlayer.getSize()) - 10, 1, 20};
+								touchingPlatform = false;
+								bodyGrid.sync(&bodyRenderQueue, &bodyHasHitbox);
+								for (int i : bodyGrid.query(feet)) {
+									if (touching(thePlayer, theBody)) {
 										touchingPlatform = true;
 										break;
-									} else {
-										touchingPlatform = false;
 									}
 								}
-							} // Checks for being on a falling platform; jumping while on one is otherwise impossible.
+
+								if (!touchingPlatform) {
+									surfaceGrid.sync(&surfaceRenderQueue);
+									for (int i : surfaceGrid.query(feet)) {
+										if (touching(thePlayer, theSurface)) {
+											touchingPlatform = true;
+											break;
+										}
+									}
+								}
+							} // Checks for being on a falling platform; jumping while on one is otherwise impossible. Only the platforms under the player's feet are looked at.
 
 							switch(event.key.keysym.sym)
 							{
 								case SDLK_s:
-									//playSound("Level Complete", soundEffects);
+									//voices.play("Level Complete");
 		                        	//wait(1);
 		                        	//nextLevel = true;
 		                        	//goto inputEnd;
 		                        	//break;
 									// (Previously used for debugging)
-								case SDLK_a:
-								case SDLK_LEFT:
-								case SDLK_d:
-								case SDLK_RIGHT:
-									playerLengthContraction = 1.0;
 									break;
 		                    	case SDLK_UP: // Game actions
 		                    	case SDLK_w:
 		                    		if (grounded || touchingPlatform) {
-		                    			playSound("Jump", soundEffects);
+		                    			voices.play("Jump");
 		                    			thePlayer.jump(static_cast<int>(165*playerSize));
 		                    			grounded = false;
 		                    			touchingPlatform  = false;
@@ -1236,20 +870,22 @@ int main(int argc, char* args[])
 		                    		}
 		                    		break;	
 		                        case SDLK_e:
-		                        	if (entityDistance(thePlayer, objectRenderQueue[1]) < 80 && !simulCamera.playerInFrame) { // Player is near relativity camera
+		                        	if (proximity.inRange(CAMERA) && !simulCamera.playerInFrame) { // Player is near relativity camera
 		                        		cutsceneCode = relativityOn ? 'D' : 'A';
 			                        	relativityOn = !relativityOn;
 			                        	train.playerInFrame = !train.playerInFrame;
 			                        	camera.playerInFrame = !camera.playerInFrame;
 			                        	gameState = 1;
+			                        	timers.cancel(cameraTimeout);
+			                        	timers.cancel(ticking);
 			                        	if (relativityOn) {
-			                        		targetTime[1] = timer + 18000;
-			                        		targetTime[5] = targetTime[1] - 3000;
+			                        		cameraTimeout = timers.start(CAMERA_TIMEOUT, 18000);
+			                        		ticking = timers.start(TICKING, 15000); // For the last 3000 ticks.
 			                        	}			                  
-		                        	} else if (b < 50) { // Player is near tutorialHolo (Add full cutscenes later)
+		                        	} else if (proximity.inRange(TUTORIAL)) { // Player is near tutorialHolo (Add full cutscenes later)
 		                        		stopMusic();
-		                        		stopSound();
-		                        		playSound("Tutorial", soundEffects);
+		                        		voices.stopAll();
+		                        		voices.play("Tutorial");
 		                        		switch (currentLevel)
 		                        		{
 		                        			case 5:
@@ -1270,18 +906,20 @@ int main(int argc, char* args[])
 		                        			default:
 		                        				break;
 		                        		}
-		                        	} else if (entityDistance(thePlayer, objectRenderQueue[2]) < 50 && !camera.playerInFrame) { // Player is near other relativity camera
+		                        	} else if (proximity.inRange(SIMUL_CAMERA) && !camera.playerInFrame) { // Player is near other relativity camera
 		                        		cutsceneCode = relativityOn ? 'D' : 'A';
 			                        	relativityOn = !relativityOn;
 			                        	train.playerInFrame = !train.playerInFrame;
 			                        	simulCamera.playerInFrame = !simulCamera.playerInFrame;
 			                        	gameState = 1;
+			                        	timers.cancel(simulCameraTimeout);
+			                        	timers.cancel(ticking);
 			                        	if (relativityOn) {
-			                        		targetTime[2] = timer + 18000;
-			                        		targetTime[5] = targetTime[2] - 3000;
+			                        		simulCameraTimeout = timers.start(SIMUL_CAMERA_TIMEOUT, 18000);
+			                        		ticking = timers.start(TICKING, 15000); // For the last 3000 ticks.
 			                        	}	
 		                        	} else if (exitDoorOpen) {          		
-		                        		playSound("Level Complete", soundEffects);
+		                        		voices.play("Level Complete");
 		                        		restartLevel:
 		                        		wait(1);
 		                        		nextLevel = true;
@@ -1291,7 +929,7 @@ int main(int argc, char* args[])
 		                        case SDLK_r:
 		                        	if (HP > 0) {
 		                        		currentLevel -= 1;
-		                        		playSound("Restart", soundEffects);
+		                        		voices.play("Restart");
 		                        		goto restartLevel;
 		                        	}         
 		                        	break;
@@ -1299,12 +937,19 @@ int main(int argc, char* args[])
 		                        	if (HP > 0) {
 		                        		titleLayer = 'T';
 			                        	gameState = 2;
-			                        	playSound("Quit to Title", soundEffects);
+			                        	voices.play("Quit to Title");
 			                        	window.fadeOut(blackCover, 200);
 			                        	wait(1);
 			                        	stopMusic();
 		                        	}
 		                        	break;
+		                        case SDLK_v:
+		                        	splitView = !splitView;
+		                        	break;
+		                        case SDLK_l:
+		                        	lightDelayOn = !lightDelayOn;
+		                        	lightDelay.clear(); // Turning it back on starts from where everything is now.
+		                        	break;
 		                    	default:
 		                        	break;
 		                	}
@@ -1322,526 +967,466 @@ int main(int argc, char* args[])
 				leftPressed = keystate[SDL_SCANCODE_LEFT] || keystate[SDL_SCANCODE_A];
 				rightPressed = keystate[SDL_SCANCODE_RIGHT] || keystate[SDL_SCANCODE_D];
 
-				if (landedIndex >= 0 && ((leftPressed && rightPressed) || (!leftPressed && !rightPressed))) {
-					thePlayer.setXPrime(surfaceRenderQueue[landedIndex].getXPrime());
-					if (surfaceRenderQueue[landedIndex].getYPrime() > 0) {
-						thePlayer.setYPrime(surfaceRenderQueue[landedIndex].getYPrime());
-					}
-					if (thePlayer.getXPrime() == surfaceRenderQueue[landedIndex].getXPrime()) {
-						thePlayer.setWidth(playerWidth[3]);
-						thePlayer.setHeight(playerHeight[3]);
-						thePlayer.setTexture(playerWalk[3]);
-						playerLengthContraction = 1.0;
+				if (trainTicks > 0) {
+					if (landedIndex >= 0 && ((leftPressed && rightPressed) || (!leftPressed && !rightPressed))) {
+						thePlayer.setXPrime(surfaceRenderQueue[landedIndex].getXPrime());
+						if (surfaceRenderQueue[landedIndex].getYPrime() > 0) {
+							thePlayer.setYPrime(surfaceRenderQueue[landedIndex].getYPrime());
+						}
+						if (thePlayer.getXPrime() == surfaceRenderQueue[landedIndex].getXPrime()) {
+							thePlayer.setWidth(playerWidth[3]);
+							thePlayer.setHeight(playerHeight[3]);
+							thePlayer.setTexture(playerWalk[3]);
+						}
 					}
-				}
 
-				if (leftPressed && !(rightPressed))
-				{
-					if (thePlayer.getXPrime() >= -1*maxSpeed) {
-						thePlayer.addVelVector(WEST,1);
-						facing = false;	
-						if (relativityOn)
-							playerLengthContraction -= 0.01 * gamma;
-					}		
+					if (leftPressed && !(rightPressed))
+					{
+						if (thePlayer.getXPrime() >= -1*maxSpeed) {
+							thePlayer.addVelVector(WEST,1);
+							facing = false;	
+						}		
 
-					c++; // lol
-					j = static_cast<int>(floor(static_cast<float>((c%1000)/100)));
-					thePlayer.setWidth(playerWidth[j]);
-					thePlayer.setHeight(playerHeight[j]);
-					thePlayer.setTexture(playerWalk[j]);
-				}
-				if (!(leftPressed) && rightPressed)
-				{
-					if (thePlayer.getXPrime() <= maxSpeed) {
-						thePlayer.addVelVector(EAST,1);
-						facing = true;
-						if (relativityOn)
-							playerLengthContraction -= 0.01 * gamma;
+						c++; // lol
+						j = static_cast<int>(floor(static_cast<float>((c%1000)/100)));
+						thePlayer.setWidth(playerWidth[j]);
+						thePlayer.setHeight(playerHeight[j]);
+						thePlayer.setTexture(playerWalk[j]);
 					}
+					if (!(leftPressed) && rightPressed)
+					{
+						if (thePlayer.getXPrime() <= maxSpeed) {
+							thePlayer.addVelVector(EAST,1);
+							facing = true;
+						}
 
-					c++;
-					j = static_cast<int>(floor(static_cast<float>((c%1000)/100)));
-					thePlayer.setWidth(playerWidth[j]);
-					thePlayer.setHeight(playerHeight[j]);
-					thePlayer.setTexture(playerWalk[j]);
-				}
-				if (((leftPressed && rightPressed) || (!leftPressed && !rightPressed)) && (thePlayer.getXPrime() != 0))
-				{
-					thePlayer.setXPrime(thePlayer.getXPrime() * 0.99);
-					if (relativityOn || playerLengthContraction < 1)
-							playerLengthContraction *= 1.05;
-					if (abs(thePlayer.getXPrime()) < 1 && !iFrame) {
-						thePlayer.stopX();
-						thePlayer.setWidth(playerWidth[3]);
-						thePlayer.setHeight(playerHeight[3]);
-						thePlayer.setTexture(playerWalk[3]);
-						playerLengthContraction = 1.0;
-					}		
-				} 
-
-
-				if (playerLengthContraction > 1.0)
-					playerLengthContraction = 1.0;
-				if (playerLengthContraction < 0.5)
-					playerLengthContraction = 0.5; // Prevents too much warping due to length contraction.
+						c++;
+						j = static_cast<int>(floor(static_cast<float>((c%1000)/100)));
+						thePlayer.setWidth(playerWidth[j]);
+						thePlayer.setHeight(playerHeight[j]);
+						thePlayer.setTexture(playerWalk[j]);
+					}
+					if (((leftPressed && rightPressed) || (!leftPressed && !rightPressed)) && (thePlayer.getXPrime() != 0))
+					{
+						thePlayer.setXPrime(thePlayer.getXPrime() * 0.99);
+						if (abs(thePlayer.getXPrime()) < 1 && !iFrame) {
+							thePlayer.stopX();
+							thePlayer.setWidth(playerWidth[3]);
+							thePlayer.setHeight(playerHeight[3]);
+							thePlayer.setTexture(playerWalk[3]);
+						}		
+					}
+				} // Walking speeds up, slows down and animates on the train's clock.
 
-				// Object rendering
+				// Relativity Updating
 
-				objectRendering:
+				if (relativityOn && gameState == 0) {
+					const RelativityEngine::Factors& factors = relativityEngine.between(train, camera.playerInFrame ? camera : simulCamera);
+					views[0] = {true, true, &lorentz, factors.redshift, factors.blueshift, static_cast<float>(factors.beta), SPLIT_RIGHT};
+					lorentz.setFrame(factors);
+					dopplerAudio.setTarget(factors.doppler, 1/factors.gamma); // Heard from the camera, the train is lower by the doppler factor and slower by gamma.
+				} else {
+					views[0] = {false, true, &lorentz, 0, 0, 0, SPLIT_LEFT};
+					lorentz.clearFrame();
+					dopplerAudio.setTarget(1, 1);
+				}
 
-				window.clear();
-				
-				for (unsigned int i = 0; i < backgroundRenderQueue.size(); i++) {
+				viewCount = 1;
+				if (splitView && gameState == 0) {
 					if (relativityOn) {
-						dopplerEffect(theBackground, redshiftAmount, blueshiftAmount);
+						views[1] = {false, false, &splitLorentz, 0, 0, 0, SPLIT_LEFT};
+						splitLorentz.clearFrame();
 					} else {
-						resetColour(theBackground);
+						const RelativityEngine::Factors& factors = relativityEngine.between(train, camera);
+						views[1] = {true, false, &splitLorentz, factors.redshift, factors.blueshift, static_cast<float>(factors.beta), SPLIT_RIGHT};
+						splitLorentz.setFrame(factors);
 					}
-					window.renderFullscreen(theBackground);
+					viewCount = 2;
+				} // The train's frame always goes on the left, and the camera's on the right. Set before the factors are updated below, so a view's first frame is drawn with its own.
+
+				playerContraction = lorentz.contraction(thePlayer);
+				lorentz.update(&bodyRenderQueue, &surfaceRenderQueue); // Rendering and collision below read these rather than each working out their own.
+				if (viewCount > 1)
+					splitLorentz.update(&bodyRenderQueue, &surfaceRenderQueue);
+
+				if (lightDelayOn) {
+					const Entity& observer = (relativityOn && objectRenderQueue.size() > 2) ? objectRenderQueue[camera.playerInFrame ? 1 : 2] : thePlayer;
+					lightDelay.setObserver(observer.centerOf().first, observer.centerOf().second, GAME_SPEED_OF_LIGHT * Body::dt);
+					lightDelay.update(&bodyRenderQueue, &surfaceRenderQueue, thePlayer, timer);
+				} // Seen from the camera while watching through it, and through the player's own eyes otherwise.
+
+				// Hazard scheduling
+
+				if (!hazardsLoaded) {
+					hazards.clear();
+					lightningStruck.clear();
+					for (unsigned int i = 0; i < surfaceRenderQueue.size(); i++) {
+						if (surfaceAnimationCode[i] == 'L' || surfaceAnimationCode[i] == 'R') {
+							double x = theSurface.centerOf().first - CENTER.first, strike = (surfaceAnimationCode[i] == 'L') ? 10 : 2010;
+							hazards.add({x, strike, 4000, LIGHTNING_STRIKE, theSurface.getInstanceId()});
+							hazards.add({x, strike + 2000, 4000, LIGHTNING_END, theSurface.getInstanceId()}); // Always straight after its strike, which the resync below relies on.
+						}
+					} // On the train, the left-facing beams strike together and the right-facing ones half a cycle later.
+
+					launchers.clear();
+					if (currentLevel >= 1 && currentLevel <= static_cast<int>(levelArray.size())) {
+						for (const LevelElement& element : levelArray[currentLevel-1].elements) {
+							if (element.name.compare(0, 15, "missileLauncher") != 0 || std::atoi(element.name.c_str() + 15) <= 0)
+								continue;
+							Launcher launcher = {element.elementX, element.elementY, -70, 0, WEST};
+							if (currentLevel == 9 && element.elementX < 900)
+								launcher = {element.elementX, element.elementY, 70, 180, EAST};
+							else if (currentLevel == 11)
+								launcher = {element.elementX, element.elementY, -20, 90, SOUTH};
+							launchers[std::atoi(element.name.c_str() + 15)] = launcher;
+						}
+					} // Level 9's launcher on the left wall faces the other way, and level 11's point down from the ceiling.
+					if (currentLevel == 11) {
+						for (auto& launcher : launchers)
+							hazards.add({launcher.second.x - CENTER.first, static_cast<double>(launcher.first), 3000, MISSILE_LAUNCH, launcher.first});
+					} // Fired together on the train.
+
+					for (TimerId& t : levelTimers)
+						timers.cancel(t);
+					levelTimers.clear();
+					levelTimers.push_back(timers.start(LENS_BLINK, TimerWheel::until(timers.now() - levelStart, 500, 0), 500));
+
+					bool flamesF = false, flamesG = false, beams = false;
+					for (unsigned int i = 0; i < surfaceRenderQueue.size(); i++) {
+						if (surfaceAnimationCode[i] == 'F') {
+							flamesF = true;
+							if ((timers.now() - levelStart)%12000 < 5000)
+								theSurface.unvanish();
+							else
+								theSurface.vanish();
+						} else if (surfaceAnimationCode[i] == 'G') {
+							flamesG = true;
+							if ((timers.now() - levelStart)%12000 >= 6000 && (timers.now() - levelStart)%12000 < 11000)
+								theSurface.unvanish();
+							else
+								theSurface.vanish();
+						} else if (surfaceAnimationCode[i] == 'B') {
+							beams = true;
+						}
+					} // The flames are set to wherever their cycle has got to, so a hot reload doesn't knock them out of step.
+					if (flamesF) {
+						levelTimers.push_back(timers.start(FLAME_BURST, TimerWheel::until(timers.now() - levelStart, 12000, 0), 12000, 'F'));
+						levelTimers.push_back(timers.start(FLAME_OUT, TimerWheel::until(timers.now() - levelStart, 12000, 5000), 12000, 'F'));
+						if (timers.now() - levelStart <= 1)
+							voices.play("Flame Burst"); // The level starts on a burst.
+					}
+					if (flamesG) {
+						levelTimers.push_back(timers.start(FLAME_BURST, TimerWheel::until(timers.now() - levelStart, 12000, 6000), 12000, 'G'));
+						levelTimers.push_back(timers.start(FLAME_OUT, TimerWheel::until(timers.now() - levelStart, 12000, 11000), 12000, 'G'));
+					}
+					if (beams && currentLevel == 11) {
+						levelTimers.push_back(timers.start(ZAP, TimerWheel::until(timers.now() - levelStart, 2000, 100), 2000));
+						levelTimers.push_back(timers.start(ZAP, TimerWheel::until(timers.now() - levelStart, 2000, 353), 2000));
+					} // Level 5's beams depend on the frame, so they're started below.
+					if (currentLevel == 6 || currentLevel == 9) {
+						int period = (currentLevel == 6) ? 4000 : 5000;
+						for (auto& launcher : launchers) {
+							int n = launcher.first;
+							levelTimers.push_back(timers.start(LAUNCHER, TimerWheel::until(timers.now() - levelStart, period, (currentLevel == 6) ? (n-1)*2000 : n*1000), period, n));
+						}
+					} // Level 6's two launchers take turns every 2000 ticks, and level 9's three every 1000.
+
+					hazardsLoaded = true;
+					hazardFrame = nullptr;
 				}
 
-				for (unsigned int i = 0; i < backgroundObjRenderQueue.size(); i++) {
-					if (relativityOn) {
-						dopplerEffect(theBackgroundObj, redshiftAmount, blueshiftAmount);
-					} else {
-						resetColour(theBackgroundObj);
+				if (&(relativityOn ? (camera.playerInFrame ? camera : simulCamera) : train) != hazardFrame) {
+					hazardFrame = &(relativityOn ? (camera.playerInFrame ? camera : simulCamera) : train);
+					const RelativityEngine::Factors& factors = relativityEngine.between(train, *hazardFrame);
+					hazardGamma = factors.gamma;
+					hazardTime = hazardGamma * (timers.now() - levelStart);
+					hazards.setFrame(factors.beta, factors.gamma, GAME_SPEED_OF_LIGHT * Body::dt, hazardTime);
+
+					timers.cancel(beamToggle);
+					if (currentLevel == 5)
+						beamToggle = timers.start(BEAM_TOGGLE, TimerWheel::until(timers.now() - levelStart, relativityOn ? 900 : 300, 100), relativityOn ? 900 : 300); // Slowed to a third while watching through the camera.
+
+					for (int e = 0; e < hazards.size(); e++) {
+						if (hazards.event(e).kind != LIGHTNING_STRIKE)
+							continue;
+						int i = findInstance(&surfaceRenderQueue, hazards.event(e).target);
+						double struck, ended;
+						if (i < 0)
+							continue;
+						if (hazards.last(e, hazardTime, &struck) && !(hazards.last(e+1, hazardTime, &ended) && ended > struck)) {
+							theSurface.unvanish();
+							lightningStruck[theSurface.getInstanceId()] = struck;
+						} else {
+							theSurface.vanish();
+							resetTransparency(theSurface);
+						}
+					} // Each beam is put in whatever state it would be in had the player always watched from here, without replaying the strikes in between.
+				} // Rescheduled when the level starts and whenever the player changes frame, since a new frame moves every event in time.
+
+				hazardTime = hazardGamma * (timers.now() - levelStart); // The train's clock is the wheel's, and dilation makes the watching frame's run gamma times as fast.
+				while (hazards.pop(hazardTime, &hazard)) {
+					if (hazard.kind == MISSILE_LAUNCH) {
+						auto launcher = launchers.find(hazard.target);
+						if (launcher != launchers.end()) {
+							voices.play("Missile Shot");
+							fireMissile(renderQueues, missile, launcher->second.x + launcher->second.muzzle, launcher->second.y+20, launcher->second.tilt, launcher->second.direction);
+						}
+						continue;
 					}
-					window.render(theBackgroundObj, backgroundObjRenderSize[i]);
-				}
 
-				for (unsigned int i = 0; i < objectRenderQueue.size(); i++) {
-					if (relativityOn) {
-						dopplerEffect(theObject, redshiftAmount, blueshiftAmount);
+					int i = findInstance(&surfaceRenderQueue, hazard.target);
+					if (i < 0)
+						continue;
+					if (hazard.kind == LIGHTNING_STRIKE) {
+						voices.play("Lightning");
+						theSurface.unvanish();
+						lightningStruck[hazard.target] = hazard.time;
 					} else {
-						resetColour(theObject);
-					}
-					window.render(theObject, objectRenderSize[i], 1.0, 1.0, false, false, theObject.getTilt());
-
-					if (theObject == door[1] && entityDistance(thePlayer, theObject) <= 220) {
-						theObject.setTexture(door[2]);
-						playSound("Door Open", soundEffects);
-					} else if (theObject == door[2] && entityDistance(thePlayer, theObject) > 220) {
-						theObject.setTexture(door[1]);
-					} else if (theObject == door[2] && entityDistance(thePlayer, theObject) < 50) {
-						exitDoorOpen = true;
-					} else if (theObject == door[2] && entityDistance(thePlayer, theObject) > 50) {
-						exitDoorOpen = false;
+						theSurface.vanish();
+						resetTransparency(theSurface);
 					}
+				} // Only the next occurrence of each event is queued, so this is a single comparison on ticks where nothing happens.
 
-					if (theObject == cameraLaptop[0] && entityDistance(thePlayer, cameraActivator) < 250) {
-						theObject.setTexture(cameraLaptop[1]);
-					} 
-					if (theObject == cameraLaptop[1] && entityDistance(thePlayer, cameraActivator) >= 250) {
-						theObject.setTexture(cameraLaptop[0]);
-					}
+				// Object rendering
 
-					if (theObject == simulCameraLaptop[0] && entityDistance(thePlayer, simulCameraActivator) < 250) {
-						theObject.setTexture(simulCameraLaptop[1]);
-					} else if (theObject == simulCameraLaptop[1] && entityDistance(thePlayer, simulCameraActivator) >= 250) {
-						theObject.setTexture(simulCameraLaptop[0]);
-					}
+				objectRendering:
 
-					if (theObject == tutorialHolo)
-					{
-						switch(currentLevel)
-						{
-							case 5:
-								theObject.setY(47 + 10*sin(0.001 * timer));
-								break;
-							case 7:
-								theObject.setY(580 + 10*sin(0.001 * timer));
-								break;
-							case 10:
-								theObject.setY(460 + 10*sin(0.001 * timer));			
-								break;
-							default:
-								break;
+				window.clear();
+
+				for (int v = 0; v < viewCount; v++) {
+					const View& view = views[v];
+					window.setViewport((viewCount > 1) ? &view.area : nullptr);
+
+					for (unsigned int i = 0; i < backgroundRenderQueue.size(); i++) {
+						if (view.relativity) {
+							dopplerEffect(theBackground, view.redshift, view.blueshift);
+						} else {
+							resetColour(theBackground);
 						}
-						b = entityDistance(thePlayer, theObject);
-						theObject.setTexture(b < 50 ? tutorialPoint[1] : tutorialPoint[0]);
-						setTransparency(theObject, b < 50 ? 195 : 95);
+						window.renderFullscreen(theBackground);
 					}
 
-					if (currentLevel != 5 && currentLevel != 7 && currentLevel != 10) {
-						b = 0xFFFF;
+					window.beginAberration(view.aberrationBeta); // The background is left out, so it fills in whatever the warp pulls away from the edges of the screen.
+
+					for (unsigned int i = 0; i < backgroundObjRenderQueue.size(); i++) {
+						if (view.relativity) {
+							dopplerEffect(theBackgroundObj, view.redshift, view.blueshift);
+						} else {
+							resetColour(theBackgroundObj);
+						}
+						window.render(theBackgroundObj, backgroundObjRenderSize[i]);
 					}
-				}
 
-				for (unsigned int i = 0; i < bodyRenderQueue.size(); i++) {
-					if (relativityOn) {
-						dopplerEffect(theBody, redshiftAmount, blueshiftAmount);
-					} else {
-						resetColour(theBody);
+					for (unsigned int i = 0; i < objectRenderQueue.size(); i++) {
+						if (view.relativity) {
+							dopplerEffect(theObject, view.redshift, view.blueshift);
+						} else {
+							resetColour(theObject);
+						}
+						window.render(theObject, objectRenderSize[i], 1.0, 1.0, false, false, theObject.getTilt());
 					}
-					window.render(theBody, bodyRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theBody.getXPrime()))) : 1.0, 1.0);
-					theBody.move();
-					if (theBody.isBouncy())
-						theBody.ifOnEdgeBounce();
-				}
 
-				for (unsigned int i = 0; i < surfaceRenderQueue.size(); i++) {
-					if (relativityOn) {
-						dopplerEffect(theSurface, redshiftAmount, blueshiftAmount);
-					} else {
-						resetColour(theSurface);
+					for (unsigned int i = 0; i < bodyRenderQueue.size(); i++) {
+						if (view.relativity) {
+							dopplerEffect(theBody, view.redshift, view.blueshift);
+						} else {
+							resetColour(theBody);
+						}
+						window.setOffset(view.delayed ? lightDelay.bodyOffset(i) : pair<float,float>(0, 0));
+						window.render(theBody, bodyRenderSize[i], view.lorentz->bodyContraction(i), 1.0);
 					}
+					window.setOffset({0, 0});
+
+					for (unsigned int i = 0; i < surfaceRenderQueue.size(); i++) {
+						if (view.relativity) {
+							dopplerEffect(theSurface, view.redshift, view.blueshift);
+						} else {
+							resetColour(theSurface);
+						}
+						window.setOffset(view.delayed ? lightDelay.surfaceOffset(i) : pair<float,float>(0, 0)); // Only moves where it's drawn. Everything else still sees where it really is.
 
-					if (surfaceAnimationCode[i]) {
+						float contraction = view.lorentz->surfaceContraction(i);
 						switch(surfaceAnimationCode[i])
 						{
 							case 'B':
-								window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0, false, timer%2);
-
-								if (currentLevel == 5) {
-									if (relativityOn) {
-										if (timer%900 == 100) {
-											theSurface.toggleVanished();
-											if (!theSurface.isVanished())
-												playSound("Zap", soundEffects);
-										}	
-									} else {
-										if (timer%300 == 100) {
-											theSurface.toggleVanished();
-											if (!theSurface.isVanished())
-												playSound("Zap", soundEffects);
-										}		
-									}
-								} else if (currentLevel == 11) {
-									if (timer%2000 == 100 || timer%2000 == 353) {
-										playSound("Zap", soundEffects);
-									}	
-								}
-								
-								break;
+								window.render(theSurface, surfaceRenderSize[i], contraction, 1.0, false, timer%2);
+								break; // Switched by BEAM_TOGGLE and ZAP timers.
 							case 'C':
 								if (currentLevel == 6) {
-									window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0, false, false, 180);
-
-									if (timer%4000 == 0) {
-										playSound("Missile Shot", soundEffects);
-										missile.stop();
-										missile.setTilt(0);
-										missile.setCoords(level6_missileLauncher1.elementX-70, level6_missileLauncher1.elementY+20);
-										missile.addVelVector(WEST,40);
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile, 1.2, 'M');
-									} else if (timer%4000 == 2000) {
-										playSound("Missile Shot", soundEffects);
-										missile.stop(); 
-										missile.setTilt(0); 
-										missile.setCoords(level6_missileLauncher2.elementX-70, level6_missileLauncher2.elementY+20);
-										missile.addVelVector(WEST,40);
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile, 1.2, 'M');
-									}
+									window.render(theSurface, surfaceRenderSize[i], contraction, 1.0, false, false, 180);
 								} else if (currentLevel == 9) {
-									window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0, false, false, (theSurface.getX() < 900) ? 0 : 180);
-
-									if (timer%5000 == 1000) {
-										playSound("Missile Shot", soundEffects);
-										missile.stop(); 
-										missile.setTilt(0); 
-										missile.setCoords(level9_missileLauncher1.elementX-70, level9_missileLauncher1.elementY+20); 
-										missile.addVelVector(WEST,40);
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile, 1.2, 'M');
-									} else if (timer%5000 == 2000) {
-										playSound("Missile Shot", soundEffects);
-										missile.stop(); 
-										missile.setTilt(180); 
-										missile.setCoords(level9_missileLauncher2.elementX+70, level9_missileLauncher2.elementY+20); 
-										missile.addVelVector(EAST,40);
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile, 1.2, 'M');
-									} else if (timer%5000 == 3000) {
-										playSound("Missile Shot", soundEffects);
-										missile.stop(); 
-										missile.setTilt(0); 
-										missile.setCoords(level9_missileLauncher3.elementX-70, level9_missileLauncher3.elementY+20); 
-										missile.addVelVector(WEST,40);
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile, 1.2, 'M');
-									}
+									window.render(theSurface, surfaceRenderSize[i], contraction, 1.0, false, false, (theSurface.getX() < 900) ? 0 : 180);
 								} else if (currentLevel == 11) {
-									window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0, false, false, -90);
-
-									if (simulCamera.playerInFrame) {
-										if (timer%3000 == 1) {
-											playSound("Missile Shot", soundEffects);
-											missile.stop(); 
-											missile.setTilt(90); 
-											missile.setCoords(level11_missileLauncher1.elementX-20, level11_missileLauncher1.elementY+20);
-											missile.addVelVector(SOUTH,40);
-											displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile, 1.2, 'M');
-										} else if (timer%3000 == 1502) {
-											playSound("Missile Shot", soundEffects);
-											missile.stop(); 
-											missile.setTilt(90); 
-											missile.setCoords(level11_missileLauncher2.elementX-20, level11_missileLauncher2.elementY+20); 
-											missile.addVelVector(SOUTH,40);
-											displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile, 1.2, 'M');
-										}
-									} else {
-										if (timer%3000 == 1) {
-											playSound("Missile Shot", soundEffects);
-											missile.stop(); 
-											missile.setTilt(90); 
-											missile.setCoords(level11_missileLauncher1.elementX-20, level11_missileLauncher1.elementY+20);
-											missile.addVelVector(SOUTH,40);
-											displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile, 1.2, 'M');
-										} else if (timer%3000 == 2) {
-											playSound("Missile Shot", soundEffects);
-											missile.stop(); 
-											missile.setTilt(90); 
-											missile.setCoords(level11_missileLauncher2.elementX-20, level11_missileLauncher2.elementY+20); 
-											missile.addVelVector(SOUTH,40);
-											displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile, 1.2, 'M');
-										}
-									}
-								}
-
-								
+									window.render(theSurface, surfaceRenderSize[i], contraction, 1.0, false, false, -90);
+								} // Levels 6 and 9's launchers are fired by LAUNCHER timers, and level 11's by the hazard scheduler.
 								break;
-							case 'E':
-								window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0); 
-								theSurface.setTexture(electrosphere[((timer/70)%2) + 2]); // Electricity animation.
+							case 'K':
+								window.render(theSurface, surfaceRenderSize[i], contraction, 1.0, false, false, timer/15); // rotates
 								break;
-							case 'F':
-								if (timer == 1) {
-									playSound("Flame Burst", soundEffects);
-								}
-
-								window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0);
-
-								if (timer % 12000 == 0) {
-									playSound("Flame Burst", soundEffects);
-									theSurface.toggleVanished();
-								}
-								if (timer % 12000 == 5000) {
-									theSurface.toggleVanished();
-								}
-
-								if (theSurface == flamethrowerFire[0] || theSurface == flamethrowerFire[1])
-									theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 0]);
-								if (theSurface == flamethrowerFire[2] || theSurface == flamethrowerFire[3])
-									theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 2]);
-								if (theSurface == flamethrowerFire[4] || theSurface == flamethrowerFire[5])
-									theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 4]);
-								if (theSurface == flamethrowerFire[6] || theSurface == flamethrowerFire[7])
-									theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 6]); // Flame animation.
-								
+							case 'L':
+								window.render(theSurface, surfaceRenderSize[i], 0.8, 1.0, false, false);
 								break;
-							case 'G':
-								if (timer == 1) {
-									theSurface.toggleVanished();
-								}
+							case 'M':
+								window.render(theSurface, surfaceRenderSize[i], contraction, 1.0, true, false, theSurface.getTilt());
+								break;
+							case 'R':
+								window.render(theSurface, surfaceRenderSize[i], 0.8, 1.0, true, false);
+								break;
+							default:
+								window.render(theSurface, surfaceRenderSize[i], contraction, 1.0);
+								break;
+						}
+					}
+					window.setOffset({0, 0});
 
-								window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0);
+					// Player rendering
 
-								if (timer % 12000 == 6000) {
-									playSound("Flame Burst", soundEffects);
-									theSurface.toggleVanished();
-								}
-								if (timer % 12000 == 11000) {
-									theSurface.toggleVanished();
-								}
+					if (!playerDied) {
+						if (view.relativity) {
+							dopplerEffect(thePlayer, view.redshift, view.blueshift);
+						} else {
+							resetColour(thePlayer);
+						}
 
-								if (theSurface == flamethrowerFire[0] || theSurface == flamethrowerFire[1])
-									theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 0]);
-								if (theSurface == flamethrowerFire[2] || theSurface == flamethrowerFire[3])
-									theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 2]);
-								if (theSurface == flamethrowerFire[4] || theSurface == flamethrowerFire[5])
-									theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 4]);
-								if (theSurface == flamethrowerFire[6] || theSurface == flamethrowerFire[7])
-									theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 6]); // Flame animation.
+						window.setOffset(view.delayed ? lightDelay.playerOffset() : pair<float,float>(0, 0));
+						window.render(thePlayer, playerSize, view.lorentz->contraction(thePlayer), 1.0, !facing); // The player is not contracted in the y direction, because in the train's frame of reference they are only moving at near-light speed in the x direction.
+						window.setOffset({0, 0});
+					} // gameEnd draws them hurt instead.
+					window.endAberration();
 
-								break;
-							case 'H':
-								window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0);
+					if (view.relativity) {
+						window.renderFullscreen(lens);
+						window.renderFullscreen(lensrec); // The camera lens must be rendered after everything else to appear on the top layer.
+					}
+				}
+				window.setViewport(nullptr); // Every view is drawn from the same tick, so a second one costs its draw calls and nothing else.
 
-								theSurface.changeY(0.005*sin(timer/300.0));
+				// Animation
 
-								if (sdlCollided(thePlayer, theSurface)) {
-									playSound("Heal", soundEffects);
-									removeEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, healthRefill);
-									HP = 3;
-									targetTime[4] = timer + 2000;
-								}
-								
+				proximity.setIndex(TUTORIAL, -1);
+				for (unsigned int i = 0; i < objectRenderQueue.size(); i++) {
+					if (theObject == tutorialPoint[0] || theObject == tutorialPoint[1])
+					{
+						switch(currentLevel)
+						{
+							case 5:
+								theObject.setY(47 + 10*sin(0.001 * timer));
 								break;
-							case 'K':
-								window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0, false, false, timer/15); // rotates
-								if (sdlCollided(thePlayer, theSurface)) {
-									playSound("Ding", soundEffects);
-									removeEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, exitKey);
-									objectRenderQueue[0].setTexture(door[1]);
-								}
+							case 7:
+								theObject.setY(580 + 10*sin(0.001 * timer));
 								break;
-							case 'L':
-								if (timer == 1) {
-									theSurface.vanish();
-								}
-
-								if (simulCamera.playerInFrame) {
-									if (theSurface.getX() < WINDOW_WIDTH/2) {
-										if (timer%4000 == 10) {
-											playSound("Lightning", soundEffects);
-											theSurface.unvanish();
-										} else if (timer%4000 == 2010) {
-											theSurface.vanish();
-											resetTransparency(theSurface);
-										}
-									} else if (theSurface.getX() > WINDOW_WIDTH/2) {
-										if (timer%4000 == 2010) {
-											playSound("Lightning", soundEffects);
-											theSurface.unvanish();
-										} else if (timer%4000 == 10) {
-											theSurface.vanish();
-											resetTransparency(theSurface);
-										}
-									}
-								} else {
-									if (timer%4000 == 10) {
-										playSound("Lightning", soundEffects);
-										theSurface.unvanish();
-									} else if (timer%4000 == 2010) {
-										theSurface.vanish();
-										resetTransparency(theSurface);
-									}
-								}
-
-								if (!theSurface.isVanished()) {
-									setTransparency(theSurface, 0xFF - (timer%4000)/8);
-								}
-
-								window.render(theSurface, surfaceRenderSize[i], 0.8, 1.0, false, false);
+							case 10:
+								theObject.setY(460 + 10*sin(0.001 * timer));			
 								break;
-							case 'M':
-								window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0, true, false, theSurface.getTilt());
+							default:
+								break;
+						}
+						proximity.setIndex(TUTORIAL, i);
+						theObject.setTexture(proximity.inRange(TUTORIAL) ? tutorialPoint[1] : tutorialPoint[0]);
+						setTransparency(theObject, proximity.inRange(TUTORIAL) ? 195 : 95);
+					} // The hologram's texture changes when the player is near, so it's recognised by either.
+				}
 
-								if (theSurface != explosion) {
-									theSurface.setTexture(missileTextures[(timer/200)%2]);
-								} else {
-									// ???
-								}
+				proximity.update(thePlayer);
+				if (proximity.entered(DOOR_NEAR) && objectRenderQueue[0] == door[1]) {
+					objectRenderQueue[0].setTexture(door[2]);
+					voices.play("Door Open");
+				} else if (proximity.left(DOOR_NEAR) && objectRenderQueue[0] == door[2]) {
+					objectRenderQueue[0].setTexture(door[1]);
+				}
+				exitDoorOpen = proximity.inRange(DOOR_AT) && objectRenderQueue[0] == door[2];
+
+				if (proximity.entered(CAMERA_LAPTOP) || proximity.left(CAMERA_LAPTOP) || proximity.entered(SIMUL_CAMERA_LAPTOP) || proximity.left(SIMUL_CAMERA_LAPTOP)) {
+					for (unsigned int i = 0; i < objectRenderQueue.size(); i++) {
+						if (theObject == cameraLaptop[0] || theObject == cameraLaptop[1])
+							theObject.setTexture(cameraLaptop[proximity.inRange(CAMERA_LAPTOP) ? 1 : 0]);
+						else if (theObject == simulCameraLaptop[0] || theObject == simulCameraLaptop[1])
+							theObject.setTexture(simulCameraLaptop[proximity.inRange(SIMUL_CAMERA_LAPTOP) ? 1 : 0]);
+					}
+				} // Only looks for the laptops when the player has walked into or out of range of one.
 
-								if (theSurface.getX() < -200 || (theSurface.getX() > 1600)) {
-									removeEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile);
-								} else if ((sdlCollided(thePlayer, theSurface) || (currentLevel == 6 && abs(theSurface.getX() - 750) < 10)) && (theSurface != explosion)) {
-									theSurface.stop();
-									theSurface.setDamage(0);
-									theSurface.setTexture(explosion);
-									targetTime[3] = timer + 100;
-								}
-								break;
-							case 'R':
-								if (timer == 1) {
-									theSurface.vanish();
-								}
+				levelTime += trainTicks * Body::dt;
+				strideTicks += trainTicks;
+				levelStep = 0;
+				if (strideTicks >= (Body::fixedPoint ? 1 : PHYSICS_STRIDE)) {
+					levelStep = strideTicks * Body::dt;
+					strideTicks = 0;
+				} // Fixed point keeps to one tick a step, so it stays the same on every machine.
 
-								if (simulCamera.playerInFrame) {
-									if (theSurface.getX() < WINDOW_WIDTH/2) {
-										if (timer%4000 == 10) {
-											playSound("Lightning", soundEffects);
-											theSurface.unvanish();
-										} else if (timer%4000 == 2010) {
-											theSurface.vanish();
-											resetTransparency(theSurface);
-										}
-									} else if (theSurface.getX() > WINDOW_WIDTH/2) {
-										if (timer%4000 == 2010) {
-											playSound("Lightning", soundEffects);
-											theSurface.unvanish();
-										} else if (timer%4000 == 10) {
-											theSurface.vanish();
-											resetTransparency(theSurface);
-										}
-									}
-								} else {
-									if (timer%4000 == 2010) {
-										playSound("Lightning", soundEffects);
-										theSurface.unvanish();
-									} else if (timer%4000 == 10) {
-										theSurface.vanish();
-										resetTransparency(theSurface);
-									}
-								}
+				if (levelStep > 0)
+					kinematics.leap(&bodyRenderQueue, levelTime, levelStep);
+				else if (landedType == 'b' && landedIndex >= 0 && trainTicks > 0)
+					Kinematics::leap(bodyRenderQueue[landedIndex], levelTime, trainTicks * Body::dt);
 
-								if (!theSurface.isVanished()) {
-									setTransparency(theSurface, 0xFF - (timer%4000)/8);
-								}
+				for (unsigned int i = 0; i < surfaceRenderQueue.size(); i++) {
+					switch(surfaceAnimationCode[i])
+					{
+						case 'E':
+							theSurface.setTexture(electrosphere[((timer/70)%2) + 2]); // Electricity animation.
+							break;
+						case 'F': // Lit and put out by FLAME_BURST and FLAME_OUT timers.
+						case 'G': // Half a cycle behind the 'F' flames.
+							if (theSurface == flamethrowerFire[0] || theSurface == flamethrowerFire[1])
+								theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 0]);
+							if (theSurface == flamethrowerFire[2] || theSurface == flamethrowerFire[3])
+								theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 2]);
+							if (theSurface == flamethrowerFire[4] || theSurface == flamethrowerFire[5])
+								theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 4]);
+							if (theSurface == flamethrowerFire[6] || theSurface == flamethrowerFire[7])
+								theSurface.setTexture(flamethrowerFire[((timer/50)%2) + 6]); // Flame animation.
+							break;
+						case 'H':
+							theSurface.changeY(0.005*sin(timer/300.0));
+							break; // Picked up by the contact handlers after player collision.
+						case 'L':
+						case 'R':
+							if (!theSurface.isVanished()) {
+								setTransparency(theSurface, std::max(0, 0xFF - static_cast<int>(hazardTime - lightningStruck[theSurface.getInstanceId()])/8));
+							} // Fades from each strike. Struck and cleared by the hazard scheduler.
+							break;
+						case 'M':
+							if (theSurface != explosion) {
+								theSurface.setTexture(missileTextures[(timer/200)%2]);
+							} else {
+								// ???
+							}
 
-								window.render(theSurface, surfaceRenderSize[i], 0.8, 1.0, true, false);
-								break;
-						} // Performs the various obstacle and object animations.
-					} else {
-						window.render(theSurface, surfaceRenderSize[i], relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0, 1.0);
+							if (theSurface.getX() < -200 || (theSurface.getX() > 1600)) {
+								removeEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, missile);
+							} else if (currentLevel == 6 && abs(theSurface.getX() - 750) < 10 && theSurface != explosion) {
+								theSurface.stop();
+								theSurface.setDamage(0);
+								theSurface.setTexture(explosion);
+								timers.start(EXPLOSION, 100);
+							} // Missiles that hit the player are blown up by the contact handlers after player collision.
+							break;
+						default:
+							break;
 					}
+				} // Performs the various obstacle and object animations, once per tick however many views were drawn.
 
-					theSurface.move();
-					if (theSurface.isBouncy())
-						theSurface.ifOnEdgeBounce();
-					if (currentLevel == 2 && theSurface == solidShort && abs(theSurface.getX()-390) < 0.02)
-						theSurface.bounceX();	
-					if (currentLevel == 5 && theSurface == solidPlatform && (abs(theSurface.getY()-170) < 0.01 || abs(theSurface.getY()-680) < 0.01))
-						theSurface.bounceY();
-					if (currentLevel == 6 && theSurface == solidShort) {
-						if ((abs(theSurface.getX()-365) < 0.01) || abs(theSurface.getX()-220) < 0.01) {
-							theSurface.bounceX();
-						} else if ((abs(theSurface.getY()-450) < 0.07) || abs(theSurface.getY()-280) < 0.07) {
-							theSurface.bounceY();
-						}
-					}
-					if (currentLevel == 7 && theSurface == dmgPlatform) {
-						if (abs(theSurface.getX()-140) < 0.1 || abs(theSurface.getX()-70) < 0.1 || abs(theSurface.getX()-470) < 0.1 || abs(theSurface.getX()-400) < 0.1) {
-							theSurface.bounceX();
-						}
-					}
-					if (currentLevel == 8) {
-						if ((abs(theSurface.getY()-215) < 0.2 && theSurface.getYPrime() < 0) || (abs(theSurface.getY()-535) < 0.2 && theSurface.getYPrime() > 0)) {
-							theSurface.bounceY();
-						}
-					} 
-					if (currentLevel == 9 && theSurface == semisolidPlatform && (abs(theSurface.getX()-226) < 0.5 || abs(theSurface.getX()-955) < 0.5)) {
-						theSurface.bounceX();
-					}
-					if (currentLevel == 10 && theSurface == semisolidShort) {
-						if ((theSurface.getXPrime() != 0) && (abs(theSurface.getX()-209) < 0.2 || abs(theSurface.getX()-1025) < 0.2)) {
-							theSurface.bounceX();
-						} else if (theSurface.getYPrime() < 0 && abs(theSurface.getY()-200) < 0.2) {
-							theSurface.bounceY();
-						}
-					}
-					if ((currentLevel == 11 && theSurface == semisolidShort) && (theSurface.getX() < 583 && abs(theSurface.getY()-250) < 0.5)) {
-						theSurface.bounceY();
-					}
-					if (currentLevel == 12) {
-						if (theSurface.getYPrime() > 0 && abs(theSurface.getY()-530) < 0.4) {
-							theSurface.bounceY();
-						} else if (theSurface.getYPrime() < 0 && abs(theSurface.getY()-530) < 0.4) {
-							theSurface.bounceY();
-						} else if ((abs(theSurface.getX()-141) < 0.4 || abs(theSurface.getX()-800) < 0.4) && theSurface.getYPrime() == 0) {
-							theSurface.bounceX();
-						}
-					} // These dictate where the moving platforms in each level bounce back and forth.
-						
-				}
+				if (levelStep > 0)
+					kinematics.leap(&surfaceRenderQueue, levelTime, levelStep); // Moved after the render loop rather than inside it, so a surface removed mid-loop no longer makes the next one skip its move.
+				else if (landedType == 's' && landedIndex >= 0 && trainTicks > 0)
+					Kinematics::leap(surfaceRenderQueue[landedIndex], levelTime, trainTicks * Body::dt);
+				// Moving platforms follow the paths given in their level files, which say where each one turns back. The one the player is standing on is kept up to date every tick, so the player rides it smoothly instead of sinking into it or floating off it between strides.
 
 				if (playerDied) {
 					goto gameEnd;
 				}
 
-				if (iFrame || timer < targetTime[4]) {
+				if (iFrame || timers.pending(healthBarShown)) {
 					health.setTexture(healthBar[HP-1]);
 					window.render(health, 0.4);
-				}
-
-				// Player rendering
-
-				if (relativityOn) {
-					dopplerEffect(thePlayer, redshiftAmount, blueshiftAmount);
-				} else {
-					resetColour(thePlayer);
-				}
-
-				window.render(thePlayer, playerSize, playerLengthContraction, 1.0, !facing); // The player is not contracted in the y direction, because in the train's frame of reference they are only moving at near-light speed in the x direction.
+				} // Drawn once over every view, since it's part of the screen rather than the scene.
 				
-				thePlayer.move();
+				playerStartX = thePlayer.getX();
+				playerStartY = thePlayer.getY();
+				if (trainTicks > 0)
+					thePlayer.move(); // Collision only handles one step's worth of movement, and gamma >= 1 means there's never more than one.
+				stepX = thePlayer.getX() - playerStartX;
+				stepY = thePlayer.getY() - playerStartY;
+				thePlayer.setCoords(playerStartX, playerStartY); // The move is applied by the collision section below, which stops it at the first thing it hits.
 
 				if (iFrame) {
 					setTransparency(thePlayer, 128);
@@ -1850,135 +1435,194 @@ int main(int argc, char* args[])
 					}
 				}
 
-				if (relativityOn) {
-					window.renderFullscreen(lens);
-					window.renderFullscreen(lensrec); // The camera lens must be rendered after everything else to appear on the top layer.
-				}
-
-				if (timer % 500 == 0) {
-					lens.toggleVisible();
-		            lensrec.toggleVisible();
-				}
-				
 				// Player collision
 
-				for (unsigned int i = 0; i < bodyRenderQueue.size(); i++) {
+				SDL_Rect playerReach; // Not initialized here, since the goto to gameEnd below jumps over this.
+				playerReach = {static_cast<int>(std::min(playerStartX, playerStartX + stepX)) - 32, static_cast<int>(std::min(playerStartY, playerStartY + stepY)) - 32, static_cast<int>(thePlayer.getWidth()*thePlayer.getSize() + abs(stepX)) + 64, static_cast<int>(thePlayer.getHeight()*thePlayer.getSize() + abs(stepY)) + 64}; // Covers the whole of this tick's move, padded for the push-outs below.
+				bodyGrid.sync(&bodyRenderQueue, &bodyHasHitbox);
+				surfaceGrid.sync(&surfaceRenderQueue);
+				lorentz.refresh(&bodyRenderQueue, &surfaceRenderQueue);
+
+				contacts.begin();
+				for (int pass = 0; pass < 4; pass++) {
+					hitIndex = -1;
+					hitTime = 1;
+
+					for (int i : bodyGrid.query(playerReach)) {
+						int side = 0;
+						float contraction = lorentz.bodyContraction(i);
+						float t = sweptCollision(thePlayer, stepX, stepY, theBody, &side, playerContraction, contraction);
+						if (t < hitTime) {
+							hitIndex = i;
+							hitSide = side;
+							hitType = 'b';
+							hitTime = t;
+							hitContraction = contraction;
+						}
+					}
+					for (int i : surfaceGrid.query(playerReach)) {
+						int side = 0;
+						float contraction = lorentz.surfaceContraction(i);
+						float t = sweptCollision(thePlayer, stepX, stepY, theSurface, &side, playerContraction, contraction);
+						if (t < hitTime && theSurface.isSolid(side)) {
+							hitIndex = i;
+							hitSide = side;
+							hitType = 's';
+							hitTime = t;
+							hitContraction = contraction;
+						}
+					} // Finds the first thing the player would run into along the rest of their move.
+
+					if (hitIndex < 0) {
+						thePlayer.setCoords(thePlayer.getX() + stepX, thePlayer.getY() + stepY);
+						stepX = 0;
+						stepY = 0;
+
+						for (int i : bodyGrid.query(playerReach)) {
+							float contraction = lorentz.bodyContraction(i);
+							int side = collided(thePlayer, theBody, playerContraction, contraction);
+							if (side) {
+								hitIndex = i;
+								hitSide = side;
+								hitType = 'b';
+								hitContraction = contraction;
+								break;
+							}
+						}
+						if (hitIndex < 0) {
+							for (int i : surfaceGrid.query(playerReach)) {
+								float contraction = lorentz.surfaceContraction(i);
+								int side = collided(thePlayer, theSurface, playerContraction, contraction);
+								if (side && theSurface.isSolid(side)) {
+									hitIndex = i;
+									hitSide = side;
+									hitType = 's';
+									hitContraction = contraction;
+									break;
+								}
+							}
+						} // The move is clear, but a moving platform or a hot reload can still have put something on top of the player.
+						if (hitIndex < 0)
+							break;
+					}
 
-					if (!bodyHasHitbox[i])
-						continue;
+					const Body& hit = (hitType == 'b') ? bodyRenderQueue[hitIndex] : static_cast<const Body&>(surfaceRenderQueue[hitIndex]);
+					Contact contact(hitType, hitIndex, hitSide, (hitTime < 1) ? 0 : std::max(penetration(thePlayer, hit, hitSide, playerContraction, hitContraction), 0.0f));
+					contacts.add(contact); // The player is left just short of whatever they hit, so this is the only place those contacts are seen.
+
+					if (hitTime < 1) {
+						thePlayer.setCoords(thePlayer.getX() + stepX*hitTime + contact.normalX*CONTACT_SKIN, thePlayer.getY() + stepY*hitTime + contact.normalY*CONTACT_SKIN);
+						stepX *= (1 - hitTime);
+						stepY *= (1 - hitTime);
+						if (contact.normalX != 0)
+							stepX = 0;
+						if (contact.normalY != 0)
+							stepY = 0; // What's left of the move slides along whatever was hit.
+					} else {
+						thePlayer.setCoords(thePlayer.getX() + contact.normalX*(contact.depth + CONTACT_SKIN), thePlayer.getY() + contact.normalY*(contact.depth + CONTACT_SKIN));
+					}
 
-					switch(collided(thePlayer, theBody, relativityOn ? playerLengthContraction : 1.0, relativityOn ? 1/((1+abs(0.01*gamma*theBody.getXPrime()))) : 1.0))
+					switch(contact.side)
 					{
-						case 1: // right
-							thePlayer.move(-1);
-							thePlayer.stopX();
-							thePlayer.setX(thePlayer.getX()-5);
-							break;
-						case 3: // left
-							thePlayer.move(-1);
+						case Contact::RIGHT:
+						case Contact::LEFT:
 							thePlayer.stopX();
-							thePlayer.setX(thePlayer.getX()+5);
 							break;
-						case 2: // top
-							thePlayer.move(-1);
+						case Contact::TOP:
 							thePlayer.stopY();
-							thePlayer.setY(thePlayer.getY()+5);
 							thePlayer.jump(0);
+							if (iFrame) {
+								setTransparency(thePlayer, 128);
+								for (int i = 0; i < 10; i++) {
+									SDL_SetTextureAlphaMod(playerWalk[i], 128);
+								}
+							}
 							break;
-						case 4: // bottom, i.e. landing on object
-							thePlayer.move(-1);
+						case Contact::BOTTOM: // i.e. landing on a platform, object or the ground
 							thePlayer.stopY();
-							thePlayer.setY(thePlayer.getY()-2);
 							grounded = true;
-							thePlayer.setWidth(playerWidth[3]);
-							thePlayer.setHeight(playerHeight[3]);
-							thePlayer.setTexture(playerWalk[3]);
-							platformBorderL = theBody.getX();
-							platformBorderR = theBody.getX()+(theBody.getWidth()*theBody.getSize());
-							platformBorderY = theBody.getY();
+							if (hitType == 'b') {
+								thePlayer.setWidth(playerWidth[3]);
+								thePlayer.setHeight(playerHeight[3]);
+								thePlayer.setTexture(playerWalk[3]);
+							}
+							platformBorderL = hit.getX();
+							platformBorderR = hit.getX()+(hit.getWidth()*hit.getSize());
+							platformBorderY = hit.getY();
 
-							if (theBody.getXPrime() != 0 || theBody.getYPrime() != 0) {
-								landedIndex = i;
-								landedType = 'b';
+							if (hit.getXPrime() != 0 || hit.getYPrime() != 0) {
+								landedIndex = hitIndex;
+								landedType = hitType;
 							} else {
 								landedIndex = -1;
 								landedType = 'n';
 							} // A nonnegative landedIndex value indicates that the player is on a moving platform, and must accordingly update the platformBorders as the platform moves, until the player leaves it.
 							break;
-						case 0:
+						case Contact::NONE:
 							break;
 					}
-				}
+				} // Moves the player as far as they can go this tick, stopping at the first thing in the way and sliding along it, rather than moving them into things and backing them out again.
 
-				for (unsigned int i = 0; i < surfaceRenderQueue.size(); i++) {
-
-					if ((theSurface.getDamage() > 0) && (sdlCollided(thePlayer, theSurface)) && !iFrame) {
-						HP -= theSurface.getDamage();
-						playSound("Hurt", soundEffects);
-						setTransparency(thePlayer, 128);
-						for (int i = 0; i < 10; i++) {
-							SDL_SetTextureAlphaMod(playerWalk[i], 128);
-						}
-						iFrame = true;
-						targetTime[0] = timer + 2500;
+				for (int i : surfaceGrid.query(playerReach)) {
+					if (contacts.has('s', i) || !(theSurface.getDamage() > 0 || theSurface.isTrigger()))
+						continue;
+					hitSide = collided(thePlayer, theSurface);
+					if (!hitSide && levelStep > 0 && (theSurface.getXPrime() != 0 || theSurface.getYPrime() != 0) && sweptCollision(theSurface, -theSurface.getXPrime()*levelStep, -theSurface.getYPrime()*levelStep, thePlayer, &hitSide) < 1) {
+						hitSide = (hitSide + 1) % 4 + 1;
+						contacts.add(Contact('s', i, hitSide));
+					} else if (hitSide) {
+						contacts.add(Contact('s', i, hitSide, std::max(penetration(thePlayer, theSurface, hitSide), 0.0f)));
 					}
-			
-					switch(collided(thePlayer, theSurface, relativityOn ? playerLengthContraction : 1.0, relativityOn ? 1/((1+abs(0.01*gamma*theSurface.getXPrime()))) : 1.0))
-					{
-						case 1: // right
-							if (theSurface.isSolid(1)) {
-								thePlayer.move(-1);
-								thePlayer.stopX();
-								thePlayer.setX(thePlayer.getX()-5);
-							}
-							break;
-						case 3: // left
-							if (theSurface.isSolid(3)) {
-								thePlayer.move(-1);
-								thePlayer.stopX();
-								thePlayer.setX(thePlayer.getX()+5);
-							}					
-							break;
-						case 2: // top
-							if (theSurface.isSolid(2)) {
-								thePlayer.move(-1);
-								thePlayer.stopY();
-								thePlayer.setY(thePlayer.getY()+5);
-								thePlayer.jump(0);
-								if (iFrame) {
-									setTransparency(thePlayer, 128);
-									for (int i = 0; i < 10; i++) {
-										SDL_SetTextureAlphaMod(playerWalk[i], 128);
-									}
-								}	
+				} // Hazards and pickups don't stop the player, so they're found by overlap instead. Anything moving, like a missile, is also swept back along the whole stride it just moved, so it can't jump through the player.
+
+				{
+					const vector<Contact>& events = contacts.finish();
+					for (int k = events.size() - 1; k >= 0; k--) {
+						const Contact& c = events[k];
+						if (c.type != 's' || c.phase == Contact::EXIT)
+							continue;
+						int i = c.index;
+
+						if (theSurface.getDamage() > 0 && !iFrame) {
+							HP -= theSurface.getDamage();
+							voices.play("Hurt");
+							setTransparency(thePlayer, 128);
+							for (int i = 0; i < 10; i++) {
+								SDL_SetTextureAlphaMod(playerWalk[i], 128);
 							}
-							break;
-						case 4: // bottom, i.e. landing on platform or ground
-							if (theSurface.isSolid(4)) {
-								thePlayer.move(-1);
-								thePlayer.stopY();
-								thePlayer.setY(thePlayer.getY()-2);
-								grounded = true;
-								platformBorderL = theSurface.getX();
-								platformBorderR = theSurface.getX()+(theSurface.getWidth()*surfaceRenderSize[i]);
-								platformBorderY = theSurface.getY();
-
-								if (theSurface.getXPrime() != 0 || theSurface.getYPrime() != 0) {
-									landedIndex = i;
-									landedType = 's';
-								} else {
-									landedIndex = -1;
-									landedType = 'n';
+							iFrame = true;
+							timers.cancel(invulnerability);
+							invulnerability = timers.start(INVULNERABILITY, 2500);
+						}
+
+						switch(surfaceAnimationCode[i])
+						{
+							case 'H':
+								voices.play("Heal");
+								removeEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, healthRefill);
+								contacts.erase('s', i);
+								HP = 3;
+								timers.cancel(healthBarShown);
+								healthBarShown = timers.start(HEALTH_BAR, 2000);
+								break;
+							case 'K':
+								voices.play("Ding");
+								removeEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, exitKey);
+								contacts.erase('s', i);
+								objectRenderQueue[0].setTexture(door[1]);
+								proximity.reset(); // So a player already standing by the door sees it open.
+								break;
+							case 'M':
+								if (theSurface != explosion) {
+									theSurface.stop();
+									theSurface.setDamage(0);
+									theSurface.setTexture(explosion);
+									timers.start(EXPLOSION, 100);
 								}
-							}
-							break;
-						case 0:
-							break;
+								break;
+						}
 					}
-					
-
-					
-				}
+				} // Contact handlers. Hazards hurt for as long as they're touched, between the invincibility frames, and pickups go on first touch. They run from the highest index down, so removing a pickup doesn't move the ones still to be handled.
 
 				if (landedIndex >= 0) {
 					switch(landedType)
@@ -2014,7 +1658,7 @@ int main(int argc, char* args[])
 					HP--; // void damage
 				if (HP == 0) {
 					playerDied = true;
-					playSound("Game Over", soundEffects);
+					voices.play("Game Over");
 					setTransparency(thePlayer, 128);
 					for (int i = 0; i < 10; i++) {
 						SDL_SetTextureAlphaMod(playerWalk[i], 128);
@@ -2030,7 +1674,7 @@ int main(int argc, char* args[])
 					thePlayer.setTexture(playerHurt);
 
 					setTransparency(thePlayer, 128);
-					window.render(thePlayer, playerSize, playerLengthContraction, 1.0, !facing);
+					window.render(thePlayer, playerSize, playerContraction, 1.0, !facing);
 					window.display();
 					wait(2);
 					
@@ -2045,50 +1689,91 @@ int main(int argc, char* args[])
 
 				// Timer handling
 
-				if (timer == targetTime[0]) {
-					thePlayer.setWidth(playerWidth[3]);
-					thePlayer.setHeight(playerHeight[3]);
-					thePlayer.setTexture(playerWalk[3]);
-					iFrame = false;
-					resetTransparency(thePlayer);
-					for (int i = 0; i < 10; i++) {
-						SDL_SetTextureAlphaMod(playerWalk[i], 255);
+				while (timers.pop(&fired)) {
+					switch (fired.kind)
+					{
+						case INVULNERABILITY:
+							thePlayer.setWidth(playerWidth[3]);
+							thePlayer.setHeight(playerHeight[3]);
+							thePlayer.setTexture(playerWalk[3]);
+							iFrame = false;
+							resetTransparency(thePlayer);
+							for (int i = 0; i < 10; i++) {
+								SDL_SetTextureAlphaMod(playerWalk[i], 255);
+							}
+							break;
+						case CAMERA_TIMEOUT:
+							if (relativityOn && camera.playerInFrame) {
+								cutsceneCode = relativityOn ? 'D' : 'A';
+								relativityOn = !relativityOn;
+								train.playerInFrame = !train.playerInFrame;
+								camera.playerInFrame = !camera.playerInFrame;
+								gameState = 1;
+							}
+							break;
+						case SIMUL_CAMERA_TIMEOUT:
+							if (relativityOn && simulCamera.playerInFrame) {
+								cutsceneCode = relativityOn ? 'D' : 'A';
+								relativityOn = !relativityOn;
+								train.playerInFrame = !train.playerInFrame;
+								simulCamera.playerInFrame = !simulCamera.playerInFrame;
+								gameState = 1;
+							}
+							break;
+						case TICKING:
+							if (relativityOn)
+								voices.play("Ticking");
+							break;
+						case EXPLOSION:
+							removeEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, kaboom);
+							break;
+						case LENS_BLINK:
+							lens.toggleVisible();
+							lensrec.toggleVisible();
+							break;
+						case BEAM_TOGGLE:
+						{
+							bool zapped = false;
+							for (unsigned int i = 0; i < surfaceRenderQueue.size(); i++) {
+								if (surfaceAnimationCode[i] == 'B') {
+									theSurface.toggleVanished();
+									zapped = zapped || !theSurface.isVanished();
+								}
+							}
+							if (zapped)
+								voices.play("Zap");
+							break;
+						}
+						case ZAP:
+							voices.play("Zap");
+							break;
+						case LAUNCHER:
+						{
+							auto launcher = launchers.find(fired.target);
+							if (launcher != launchers.end()) {
+								voices.play("Missile Shot");
+								fireMissile(renderQueues, missile, launcher->second.x + launcher->second.muzzle, launcher->second.y+20, launcher->second.tilt, launcher->second.direction);
+							}
+							break;
+						}
+						case FLAME_BURST:
+						case FLAME_OUT:
+							for (unsigned int i = 0; i < surfaceRenderQueue.size(); i++) {
+								if (surfaceAnimationCode[i] != fired.target)
+									continue;
+								if (fired.kind == FLAME_BURST)
+									theSurface.unvanish();
+								else
+									theSurface.vanish();
+							}
+							if (fired.kind == FLAME_BURST)
+								voices.play("Flame Burst");
+							break;
+						default:
+							break;
 					}
-				}
-				if (timer == targetTime[1] && relativityOn) {
-					cutsceneCode = relativityOn ? 'D' : 'A';
-                	relativityOn = !relativityOn;
-                	train.playerInFrame = !train.playerInFrame;
-                	camera.playerInFrame = !camera.playerInFrame;
-                	gameState = 1;
-				} 
-				if (timer == targetTime[2] && relativityOn) {
-					cutsceneCode = relativityOn ? 'D' : 'A';
-                	relativityOn = !relativityOn;
-                	train.playerInFrame = !train.playerInFrame;
-                	simulCamera.playerInFrame = !simulCamera.playerInFrame;
-                	gameState = 1;
-				}
-				if (abs(timer - targetTime[3]) < 10) {
-					removeEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, kaboom);
-				} 
-				if (timer == targetTime[5] && relativityOn) {
-					playSound("Ticking", soundEffects);
-				} 
-				if (timer == targetTime[9]) {
-					std::cout << a << '\n';
-				}
-
-				// Relativity Updating
+				} // Timers that fell due during a cutscene are still waiting here when play resumes, rather than being missed.
 
-				if (relativityOn && gameState == 0) {
-					gamma = lorentzFactor(train, camera.playerInFrame ? camera : simulCamera);
-					redshiftAmount = dopplerShift(dopplerFactor(gamma)).first;
-					blueshiftAmount = dopplerShift(dopplerFactor(gamma)).second;
-				} else {
-					redshiftAmount = 0;
-					blueshiftAmount = 0;
-				}
 				if (train.playerInFrame) {
 					camera.playerInFrame = false;
 					simulCamera.playerInFrame = false;
@@ -2102,58 +1787,14 @@ int main(int argc, char* args[])
 					window.fadeOut(blackCover, 150);
 					window.clear();
 
-					if (currentLevel == 12) {
+					while (currentLevel < static_cast<int>(levelArray.size()) && !levelLoaded(levelArray[currentLevel]))
+						currentLevel++; // Levels that failed to load are passed over.
+					if (currentLevel == static_cast<int>(levelArray.size())) {
 						cutsceneCode = 'E';
 						gameState = 1;
 					} else {
-						loadLevel(levelArray[currentLevel++], thePlayer, renderQueues, exitDoor, cameraActivator, simulCameraActivator);
-
-						if (levelArray[currentLevel-1].floor)
-							displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, floorInvis);
-						if (levelArray[currentLevel-1].ceiling)
-							displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, ceilingInvis);
-						if (levelArray[currentLevel-1].leftWall)
-							displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, wallL);
-						if (levelArray[currentLevel-1].rightWall)
-							displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, wallR);
-
-						if (levelArray[currentLevel-1].doorLocked) {
-							objectRenderQueue[0].setTexture(door[0]);
-						} else {
-							objectRenderQueue[0].setTexture(door[1]);
-						}
-
-						playerSize = levelArray[currentLevel-1].playerSize;
-						relativityOn = false;
-						grounded = false;
-						facing = true;
-
-						thePlayer.setWidth(playerWidth[3]);
-						thePlayer.setHeight(playerHeight[3]);
-						thePlayer.setTexture(playerWalk[3]);
-						iFrame = false;
-						resetTransparency(thePlayer);
-						for (int i = 0; i < 10; i++) {
-							SDL_SetTextureAlphaMod(playerWalk[i], 255);
-						}
-
-						touchingPlatform = false; 
-						exitDoorOpen = false;
-						platformBorderL = -1000;
-						platformBorderR = 3000; 
-						platformBorderY = -1000; 
-						landedIndex = -1;
-						landedType = 'n';
-						playerLengthContraction = 1.0;
-						b = 100; 
-						timer = 0;
+						startLevel(currentLevel + 1);
 						train.velocity += 0.005*SPEED_OF_LIGHT;
-						train.playerInFrame = true;
-						camera.playerInFrame = false;
-						simulCamera.playerInFrame = false;
-						for (int i = 0; i <= 4; i++) {
-							targetTime[i] = -1;
-						}
 						window.display();
 					}		
 				}
@@ -2165,9 +1806,9 @@ int main(int argc, char* args[])
 				switch(cutsceneCode)
 				{
 					case('A'):
-						playSound("Activate", soundEffects);
+						voices.play("Activate");
 						wait(0.9);
-						playSound("Whir", soundEffects);
+						voices.play("Whir");
 						cameraStation.setTexture(cameraPlatform[0]);
 
 						for (int i = 1; i <= 3; i++) {
@@ -2187,9 +1828,9 @@ int main(int argc, char* args[])
 						break;
 
 					case('D'):
-						playSound("Deactivate", soundEffects);
+						voices.play("Deactivate");
 						wait(0.9);
-						playSound("Whir", soundEffects);
+						voices.play("Whir");
 						cameraStation.setTexture(cameraPlatform[3]);
 
 						for (int i = 2; i >= 0; i--) {
@@ -2283,9 +1924,10 @@ int main(int argc, char* args[])
 							wait(0.25);
 						}
 
-						cameraActivator.setCoords(level_5.cameraLocation.first, level_5.cameraLocation.second);
+						if (levelArray.size() > 4)
+							cameraActivator.setCoords(levelArray[4].cameraLocation.first, levelArray[4].cameraLocation.second);
 		                stopMusic();
-		                stopSound();
+		                voices.stopAll();
 						break;
 
 					case('2'):
@@ -2345,7 +1987,7 @@ int main(int argc, char* args[])
 						}
 	
 		                stopMusic();
-		                stopSound();
+		                voices.stopAll();
 						break;
 
 					case('3'):
@@ -2415,9 +2057,10 @@ int main(int argc, char* args[])
 							wait(0.25);
 						}
 
-						simulCameraActivator.setCoords(level_10.simulCameraLocation.first, level_10.simulCameraLocation.second);
+						if (levelArray.size() > 9)
+							simulCameraActivator.setCoords(levelArray[9].simulCameraLocation.first, levelArray[9].simulCameraLocation.second);
 		                stopMusic();
-		                stopSound();
+		                voices.stopAll();
 						break;
 
 					case('O'):
@@ -2533,7 +2176,7 @@ int main(int argc, char* args[])
 						window.render(staircase, 1, 1, 0.60);
 						window.render(frontTracks, 0.35, 0.9);
 						window.display();
-						playSound("Train Whistle", soundEffects);
+						voices.play("Train Whistle");
 						wait(2);
 
 						repeat (30) {
@@ -2562,7 +2205,7 @@ int main(int argc, char* args[])
 						}
 
 						window.fadeOut(blackCover, 85);
-						playSound("Train Accelerate", soundEffects);
+						voices.play("Train Accelerate");
 						repeat (16) {
 							musicVolume--;
 							Mix_VolumeMusic(musicVolume);
@@ -2575,12 +2218,12 @@ int main(int argc, char* args[])
 							Mix_Volume(-1,soundVolume); 
 							wait(0.125);
 						}
-						stopSound();
+						voices.stopAll();
 						wait(1);
 
 						soundVolume = (soundToggle == soundButton[1]) ? 0 : 32;
 						Mix_Volume(-1,soundVolume); 
-						playSound("Space Ambience", soundEffects);
+						voices.play("Space Ambience");
 						resetColour(cutsceneBG);
 						cutsceneBG.setTexture(indoorBackground);
 						cutscenePlayer.setWidth(playerSW);
@@ -2708,7 +2351,7 @@ int main(int argc, char* args[])
 						wait(1);
 
 						cutsceneBG.setTexture(galaxyBG);
-						playSound("Realization", soundEffects);
+						voices.play("Realization");
 						repeat (300) {
 							window.clear();
 							window.renderFullscreen(cutsceneBG);
@@ -2728,7 +2371,7 @@ int main(int argc, char* args[])
 
 						window.fadeOut(blackCover,2500);
 						wait(2);
-						stopSound();
+						voices.stopAll();
 						musicVolume = Mix_PausedMusic() ? 0 : 16;
 						soundVolume = (soundToggle == soundButton[1]) ? 0 : 32;
 						goto startGame;
@@ -2761,7 +2404,7 @@ int main(int argc, char* args[])
 							Mix_Volume(-1,soundVolume);
 						}
 						startMusic("Ending Cutscene", soundtrack);
-						playSound("Space Ambience", soundEffects);
+						voices.play("Space Ambience");
 						cutsceneBG.setTexture(indoorBackground);
 						window.renderFullscreen(cutsceneBG);
 						window.render(cutscenePlayer, 0.55);
@@ -2833,7 +2476,7 @@ int main(int argc, char* args[])
 						wait(0.03);
 						SDL_PumpEvents();
 
-						playSound("Engine Shutdown", soundEffects);
+						voices.play("Engine Shutdown");
 						wait(2);
 
 
@@ -2893,7 +2536,7 @@ int main(int argc, char* args[])
                     	gameState = 2;
                     	wait(1);
                     	stopMusic();
-						stopSound();
+						voices.stopAll();
 						musicVolume = Mix_PausedMusic() ? 0 : 16;
 						soundVolume = (soundToggle == soundButton[1]) ? 0 : 32;
 						break;
@@ -2935,7 +2578,7 @@ int main(int argc, char* args[])
 		                	if (mouseOver(play, mouseX, mouseY) && titleLayer == 'T')
 		                		titleLayer = 'P';
 		                	if (mouseOver(newGame, mouseX, mouseY) && titleLayer == 'P') {
-		                		playSound("Star Shine", soundEffects);
+		                		voices.play("Star Shine");
 		                		window.fadeOut(whiteCover, 50);
 		                		wait(0.05);
 		                		cutsceneCode = 'O';
@@ -2945,35 +2588,15 @@ int main(int argc, char* args[])
 		                		if (false) { // this block can only be goto-ed using the startGame label.
 		                			startGame:
 		                			currentLevel = 1;
-
-		                			loadLevel(levelArray[currentLevel-1], thePlayer, renderQueues, exitDoor, cameraActivator, simulCameraActivator);
-
-									if (levelArray[currentLevel-1].floor)
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, floorInvis);
-									if (levelArray[currentLevel-1].ceiling)
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, ceilingInvis);
-									if (levelArray[currentLevel-1].leftWall)
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, wallL);
-									if (levelArray[currentLevel-1].rightWall)
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, wallR);
-
-									objectRenderQueue[0].setTexture(door[levelArray[currentLevel-1].doorLocked ? 0 : 1]);
-
-									playerSize = levelArray[currentLevel-1].playerSize;
-									grounded = false;
-									facing = true;
-									iFrame = false; 
-									touchingPlatform = false; 
-									exitDoorOpen = false;
-									platformBorderL = -1000;
-									platformBorderR = 3000; 
-									platformBorderY = -1000; 
-									landedIndex = -1;
-									landedType = 'n'; 
-									timer = 0;
-									window.display();
-
-		                			gameState = 0;
+		                			while (currentLevel < static_cast<int>(levelArray.size()) && !levelLoaded(levelArray[currentLevel-1]))
+		                				currentLevel++; // Starts from the first level that loaded.
+		                			if (currentLevel <= static_cast<int>(levelArray.size()) && startLevel(currentLevel)) {
+										window.display();
+		                				gameState = 0;
+		                			} else {
+		                				std::cout << "Failed to start a new game. Error: no levels could be loaded\n";
+		                				gameState = 2;
+		                			}
 		                			cutsceneCode = 'N';
 		                			stopMusic();
 		                		}
@@ -2997,39 +2620,14 @@ int main(int argc, char* args[])
 		                		soundToggle.setTexture(soundButton[soundVolume == 0]);
 		                	}
 
-		                	for (int i = 0; i < 12; i++) {
-		                		if (mouseOver(levels[i], mouseX, mouseY) && titleLayer == 'L') {
-		                			currentLevel = ++i;
-
-		                			loadLevel(levelArray[currentLevel-1], thePlayer, renderQueues, exitDoor, cameraActivator, simulCameraActivator);
-
-									if (levelArray[currentLevel-1].floor)
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, floorInvis);
-									if (levelArray[currentLevel-1].ceiling)
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, ceilingInvis);
-									if (levelArray[currentLevel-1].leftWall)
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, wallL);
-									if (levelArray[currentLevel-1].rightWall)
-										displayEntity(&surfaceRenderQueue, &surfaceRenderSize, &surfaceAnimationCode, wallR);
-									
-									objectRenderQueue[0].setTexture(door[levelArray[currentLevel-1].doorLocked ? 0 : 1]);
-
-									playerSize = levelArray[currentLevel-1].playerSize;
-									grounded = false;
-									facing = true;
-									iFrame = false; 
-									touchingPlatform = false; 
-									exitDoorOpen = false;
-									platformBorderL = -1000;
-									platformBorderR = 3000; 
-									platformBorderY = -1000; 
-									landedIndex = -1;
-									landedType = 'n'; 
-									timer = 0;
+		                	for (int i = 0; i < 12 && i < static_cast<int>(levelArray.size()); i++) {
+		                		if (mouseOver(levels[i], mouseX, mouseY) && titleLayer == 'L' && levelLoaded(levelArray[i])) {
+		                			startLevel(i + 1);
 									window.display();
 
 		                			gameState = 0;
 		                			stopMusic();
+		                			break;
 		                		}
 		                	}
 
@@ -3065,7 +2663,7 @@ int main(int argc, char* args[])
 						break;
 					case 'L':
 						for (int i = 0; i < 12; i++) {
-							window.render(levels[i], mouseOver(levels[i], mouseX, mouseY) ? 1.55 : 1.25);
+							window.render(levels[i], (mouseOver(levels[i], mouseX, mouseY) && i < static_cast<int>(levelArray.size()) && levelLoaded(levelArray[i])) ? 1.55 : 1.25); // Levels that failed to load don't respond.
 						}	
 						break;
 					case 'C':
@@ -3086,11 +2684,16 @@ int main(int argc, char* args[])
 		}
 
 		window.display();
-		wait(relativityOn ? 90*gamma*(1.0/tickRate) : (1.0/tickRate)); // Time dilation.
+		wait(1.0/tickRate); // The same in every frame, so input and the UI keep up while the train is dilated.
 		timer++;
+		for (int n = 0; n < trainTicks; n++)
+			timers.advance(); // Gameplay timers are on the train too.
 
 	}
 	window.cleanUp();
+	voices.report();
+	voices.detach();
+	dopplerAudio.detach();
 	Mix_Quit();
 	IMG_Quit();
 	SDL_Quit();
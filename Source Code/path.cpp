@@ -0,0 +1,84 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "Path.hpp"
+
+using std::pair;
+using std::vector;
+
+Path::Path()
+: speed(0), leadIn(0), cycle(0)
+{
+}
+
+Path::Path(pair<float,float> start, float speed, const vector<pair<float,float>>& waypoints, bool loops)
+: speed(speed), leadIn(0), cycle(0)
+{
+	if (waypoints.empty())
+		return;
+
+	points.push_back(start);
+	points.insert(points.end(), waypoints.begin(), waypoints.end());
+	if (loops)
+		points.push_back(waypoints.front());
+	else
+		points.insert(points.end(), waypoints.rbegin()+1, waypoints.rend()); // A ping-pong path is a loop that comes back the way it went.
+
+	distances.push_back(0);
+	for (unsigned int i = 1; i < points.size(); i++)
+		distances.push_back(distances.back() + std::hypot(points[i].first - points[i-1].first, points[i].second - points[i-1].second));
+	leadIn = distances[1];
+	cycle = distances.back() - leadIn;
+}
+
+bool Path::isEmpty() const
+{
+	return points.empty();
+}
+
+int Path::segmentAt(double t, double* along) const
+{
+	double d = speed * t;
+	if (d < leadIn || cycle <= 0 || points.size() < 3) {
+		*along = std::min(d, leadIn);
+		return 0;
+	} // Still heading to the first waypoint, or already parked on a path with nowhere else to go.
+
+	d = leadIn + std::fmod(d - leadIn, cycle);
+	int i = std::upper_bound(distances.begin() + 1, distances.end(), d) - distances.begin() - 1;
+	i = std::min(i, static_cast<int>(points.size()) - 2);
+	*along = d - distances[i];
+	return i;
+}
+
+pair<float,float> Path::positionAt(double t) const
+{
+	if (points.empty())
+		return {0, 0};
+
+	double along;
+	int i = segmentAt(t, &along);
+	double length = distances[i+1] - distances[i];
+	if (length <= 0)
+		return points[i+1];
+
+	double f = along / length;
+	return {float(points[i].first + (points[i+1].first - points[i].first) * f), float(points[i].second + (points[i+1].second - points[i].second) * f)};
+} // The fraction along the segment is worked out in double precision, so a platform lands exactly on each waypoint rather than drifting past it.
+
+pair<float,float> Path::velocityAt(double t) const
+{
+	if (points.empty() || (speed * t >= leadIn && (cycle <= 0 || points.size() < 3)))
+		return {0, 0};
+
+	double along;
+	int i = segmentAt(t, &along);
+	double length = distances[i+1] - distances[i];
+	if (length <= 0)
+		return {0, 0};
+	return {float((points[i+1].first - points[i].first) / length * speed), float((points[i+1].second - points[i].second) / length * speed)};
+} // Kept up to date on the surface, since landing on a platform and length contraction both go by its velocity.
@@ -0,0 +1,85 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <cmath>
+
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "Proximity.hpp"
+
+int ProximityIndex::add(const Entity* e, float radius)
+{
+	zones.push_back({e, nullptr, -1, radius, INFINITY, false, false});
+	return zones.size() - 1;
+}
+
+int ProximityIndex::add(const vector<Entity>* queue, int index, float radius)
+{
+	zones.push_back({nullptr, queue, index, radius, INFINITY, false, false});
+	return zones.size() - 1;
+}
+
+void ProximityIndex::setIndex(int zone, int index)
+{
+	zones[zone].index = index;
+}
+
+const Entity* ProximityIndex::target(const Zone& z) const
+{
+	if (z.entity != nullptr)
+		return z.entity;
+	if (z.index >= 0 && z.index < static_cast<int>(z.queue->size()))
+		return &z.queue->at(z.index);
+	return nullptr;
+}
+
+void ProximityIndex::update(const Entity& player)
+{
+	pair<float,float> p = player.centerOf(), c;
+	const Entity* last = nullptr;
+
+	for (Zone& z : zones) {
+		const Entity* e = target(z);
+		if (e != nullptr && e != last)
+			c = e->centerOf();
+		last = e; // Zones on the same entity are added together, so one centre does for all of them.
+
+		z.wasInside = z.inside;
+		z.distance = (e != nullptr) ? gamefuncs::distance(p.first, c.first, p.second, c.second) : INFINITY;
+		z.inside = z.distance < z.radius;
+	}
+}
+
+bool ProximityIndex::inRange(int zone) const
+{
+	return zones[zone].inside;
+}
+
+bool ProximityIndex::entered(int zone) const
+{
+	return zones[zone].inside && !zones[zone].wasInside;
+}
+
+bool ProximityIndex::left(int zone) const
+{
+	return !zones[zone].inside && zones[zone].wasInside;
+}
+
+float ProximityIndex::distance(int zone) const
+{
+	return zones[zone].distance;
+}
+
+void ProximityIndex::reset()
+{
+	for (Zone& z : zones)
+		z.inside = false;
+}
\ No newline at end of file
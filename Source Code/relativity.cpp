@@ -0,0 +1,211 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "Relativity.hpp"
+
+double relativity::beta(const FrameOfReference& s, const FrameOfReference& sPrime)
+{
+	return (sPrime.velocity - s.velocity) / SPEED_OF_LIGHT;
+} // Dividing by c before squaring keeps the numbers near 1, where v*v/(c*c) had both terms near 1e16.
+
+double relativity::addVelocities(double beta1, double beta2)
+{
+	return (beta1 + beta2)/(1 + beta1*beta2);
+} // The same as adding rapidities, but without the atanh and tanh.
+
+double relativity::rapidity(double beta)
+{
+	return std::atanh(beta);
+}
+
+double relativity::lorentzFactor(double beta)
+{
+	return 1/std::sqrt((1 - beta)*(1 + beta)); // This formula is shown on several of the decorational blackboards in the game.
+} // Factored, since 1 - beta*beta loses the low bits of beta as it nears 1.
+
+double relativity::dopplerFactor(double beta)
+{
+	double b2 = beta*beta;
+	return std::sqrt((1 - b2)/(1 + b2));
+} // The longitudinal factor is sqrt((1-beta)/(1+beta)). The game has always used beta squared in its place, and the colour scaling in dopplerShift() is tuned to that, so it's kept.
+
+std::pair<Uint8,Uint8> relativity::dopplerShift(double dFactor)
+{
+	std::pair<Uint8,Uint8> shiftAmounts;
+
+	shiftAmounts.first = -99.6*dFactor + 139.84;
+	shiftAmounts.second = -9.96*dFactor + 13.984; // These scale the redshift, so it's not too exaggerated.
+
+	return shiftAmounts;
+}
+
+const RelativityEngine::Factors& RelativityEngine::between(const FrameOfReference& s, const FrameOfReference& sPrime)
+{
+	Entry* entry = nullptr;
+	for (Entry& e : entries) {
+		if (e.s == &s && e.sPrime == &sPrime)
+			entry = &e;
+	}
+	if (entry != nullptr && entry->sVelocity == s.velocity && entry->sPrimeVelocity == sPrime.velocity)
+		return entry->factors;
+
+	if (entry == nullptr) {
+		entries.push_back({&s, &sPrime, 0, 0, {}});
+		entry = &entries.back();
+	}
+	entry->sVelocity = s.velocity;
+	entry->sPrimeVelocity = sPrime.velocity;
+
+	Factors& f = entry->factors;
+	f.beta = relativity::beta(s, sPrime);
+	f.rapidity = relativity::rapidity(f.beta);
+	f.gamma = relativity::lorentzFactor(f.beta);
+	f.doppler = relativity::dopplerFactor(f.beta);
+	std::pair<Uint8,Uint8> shift = relativity::dopplerShift(f.doppler);
+	f.redshift = shift.first;
+	f.blueshift = shift.second;
+	computed++;
+	return f;
+}
+
+int RelativityEngine::advance(FrameOfReference& frame, const FrameOfReference& watching, double ticks)
+{
+	double before = std::floor(frame.properTime);
+	frame.properTime += ticks / between(watching, frame).gamma;
+	return static_cast<int>(std::floor(frame.properTime) - before);
+} // Only whole ticks are handed out, so whatever steps on them takes the same fixed-size steps in every frame, and the fraction left over carries into the next call.
+
+int RelativityEngine::recomputations() const
+{
+	return computed;
+}
+
+void RelativisticKinematics::setFrame(const RelativityEngine::Factors& frame)
+{
+	on = true;
+	beta = -frame.beta; // frame.beta is the watcher's velocity relative to the train, so the train's relative to the watcher is its negative.
+}
+
+void RelativisticKinematics::clearFrame()
+{
+	on = false;
+	beta = 0;
+}
+
+void RelativisticKinematics::factors(const float* velocity, float* contraction, float* dilation, int count) const
+{
+	if (!on) {
+		std::fill(contraction, contraction + count, 1.0f);
+		std::fill(dilation, dilation + count, 1.0f);
+		return;
+	}
+
+	int i = 0;
+#if defined(__AVX__)
+	__m256 scale = _mm256_set1_ps(1/GAME_SPEED_OF_LIGHT), limit = _mm256_set1_ps(MAX_BETA), negLimit = _mm256_set1_ps(-MAX_BETA);
+	__m256 frameBeta = _mm256_set1_ps(beta), one = _mm256_set1_ps(1), least = _mm256_set1_ps(MIN_CONTRACTION);
+	for (; i + 8 <= count; i += 8) {
+		__m256 u = _mm256_max_ps(negLimit, _mm256_min_ps(limit, _mm256_mul_ps(_mm256_loadu_ps(velocity + i), scale)));
+		__m256 k = _mm256_div_ps(_mm256_sqrt_ps(_mm256_mul_ps(_mm256_sub_ps(one, u), _mm256_add_ps(one, u))), _mm256_add_ps(one, _mm256_mul_ps(frameBeta, u)));
+		_mm256_storeu_ps(contraction + i, _mm256_max_ps(least, k));
+		_mm256_storeu_ps(dilation + i, _mm256_div_ps(one, k));
+	}
+#else
+	__m128 scale = _mm_set1_ps(1/GAME_SPEED_OF_LIGHT), limit = _mm_set1_ps(MAX_BETA), negLimit = _mm_set1_ps(-MAX_BETA);
+	__m128 frameBeta = _mm_set1_ps(beta), one = _mm_set1_ps(1), least = _mm_set1_ps(MIN_CONTRACTION);
+	for (; i + 4 <= count; i += 4) {
+		__m128 u = _mm_max_ps(negLimit, _mm_min_ps(limit, _mm_mul_ps(_mm_loadu_ps(velocity + i), scale)));
+		__m128 k = _mm_div_ps(_mm_sqrt_ps(_mm_mul_ps(_mm_sub_ps(one, u), _mm_add_ps(one, u))), _mm_add_ps(one, _mm_mul_ps(frameBeta, u)));
+		_mm_storeu_ps(contraction + i, _mm_max_ps(least, k));
+		_mm_storeu_ps(dilation + i, _mm_div_ps(one, k));
+	}
+#endif
+	for (; i < count; i++) {
+		float u = std::max(-MAX_BETA, std::min(MAX_BETA, velocity[i] * (1/GAME_SPEED_OF_LIGHT)));
+		float k = std::sqrt((1 - u)*(1 + u))/(1 + beta*u);
+		contraction[i] = std::max(MIN_CONTRACTION, k);
+		dilation[i] = 1/k;
+	}
+} // k is gamma/gamma(w), where w is the entity's velocity added to the train's: its contraction in the watching frame over that of something at rest on the train. Written out, gamma cancels and k = sqrt(1 - u^2)/(1 + beta*u), which is exactly 1 for anything at rest, so static platforms keep their exact widths.
+
+template <class T>
+void RelativisticKinematics::update(const vector<T>* queue, Cache& cache)
+{
+	int count = queue->size();
+	cache.velocity.resize(count);
+	cache.contraction.resize(count);
+	cache.dilation.resize(count);
+	for (int i = 0; i < count; i++)
+		cache.velocity[i] = (*queue)[i].getXPrime();
+
+	factors(cache.velocity.data(), cache.contraction.data(), cache.dilation.data(), count);
+	cache.data = queue->data();
+	cache.size = count;
+} // Only x velocities matter, since the frames only move relative to each other in x.
+
+void RelativisticKinematics::update(const vector<Body>* bodyQueue, const vector<Surface>* surfaceQueue)
+{
+	update(bodyQueue, bodies);
+	update(surfaceQueue, surfaces);
+}
+
+void RelativisticKinematics::refresh(const vector<Body>* bodyQueue, const vector<Surface>* surfaceQueue)
+{
+	if (bodies.size != bodyQueue->size() || bodies.data != bodyQueue->data())
+		update(bodyQueue, bodies);
+	if (surfaces.size != surfaceQueue->size() || surfaces.data != surfaceQueue->data())
+		update(surfaceQueue, surfaces);
+}
+
+float RelativisticKinematics::bodyContraction(int index) const
+{
+	return (index < static_cast<int>(bodies.size)) ? bodies.contraction[index] : 1.0f;
+}
+
+float RelativisticKinematics::surfaceContraction(int index) const
+{
+	return (index < static_cast<int>(surfaces.size)) ? surfaces.contraction[index] : 1.0f;
+}
+
+float RelativisticKinematics::bodyDilation(int index) const
+{
+	return (index < static_cast<int>(bodies.size)) ? bodies.dilation[index] : 1.0f;
+}
+
+float RelativisticKinematics::surfaceDilation(int index) const
+{
+	return (index < static_cast<int>(surfaces.size)) ? surfaces.dilation[index] : 1.0f;
+}
+
+float RelativisticKinematics::contraction(const Body& b) const
+{
+	float velocity = b.getXPrime(), c, d;
+	factors(&velocity, &c, &d, 1);
+	return c;
+}
+
+float RelativisticKinematics::dilation(const Body& b) const
+{
+	float velocity = b.getXPrime(), c, d;
+	factors(&velocity, &c, &d, 1);
+	return d;
+}
\ No newline at end of file
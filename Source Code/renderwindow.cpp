@@ -1,20 +1,22 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <iostream>
+#include <vector>
 #include <Windows.h>
 
 #include "RenderWindow.hpp"
 #include "Entity.hpp"
+#include "Aberration.hpp"
 
 RenderWindow::RenderWindow(const char* title, int w, int h)
-	:window(nullptr), renderer(nullptr)
+	:window(nullptr), renderer(nullptr), offset(0, 0), width(w), height(h), aberration(w, h), warpTarget(nullptr), warping(false), warpFailed(false), squeezing(false), viewport{0, 0, w, h}, viewportSet(false)
 {
 	window = SDL_CreateWindow(title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, w, h, SDL_WINDOW_SHOWN);
 
 	if (window == nullptr)
 		std::cout << "Window display failed. Error: " << SDL_GetError() << std::endl;
 
-	renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+	renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
 }
 
 SDL_Texture* RenderWindow::loadTexture(const char* filePath) 
@@ -31,6 +33,8 @@ SDL_Texture* RenderWindow::loadTexture(const char* filePath)
 
 void RenderWindow::cleanUp()
 {
+	if (warpTarget != nullptr)
+		SDL_DestroyTexture(warpTarget);
 	SDL_DestroyWindow(window);
 }
 
@@ -48,8 +52,8 @@ void RenderWindow::render(Entity& e, float scaleFactor, float contractionFactorH
 	src.h = e.getHeight();
 
 	SDL_Rect dst;
-	dst.x = e.getX();
-	dst.y = e.getY();
+	dst.x = e.getX() + offset.first;
+	dst.y = e.getY() + offset.second;
 	dst.w = src.w * scaleFactor * contractionFactorH;
 	dst.h = src.h * scaleFactor * contractionFactorV;
 
@@ -84,11 +88,95 @@ void RenderWindow::render(Entity& e, float scaleFactor, float contractionFactorH
 
 void RenderWindow::renderFullscreen(Entity& e)
 {
-	SDL_RenderCopy(renderer, e.getTexture(), nullptr, nullptr);
+	SDL_RenderCopy(renderer, e.getTexture(), nullptr, (viewportSet && !warping && !squeezing) ? &viewport : nullptr);
+}
+
+void RenderWindow::setOffset(std::pair<float,float> offset)
+{
+	this->offset = offset;
+}
+
+void RenderWindow::beginAberration(float beta)
+{
+	if ((beta == 0 && !viewportSet) || warping || squeezing)
+		return; // A viewport always needs the target, to be squeezed into it.
+
+	if (warpFailed) {
+		if (viewportSet) {
+			float scaleX = static_cast<float>(viewport.w) / width, scaleY = static_cast<float>(viewport.h) / height;
+			SDL_Rect scaled = {static_cast<int>(viewport.x / scaleX), static_cast<int>(viewport.y / scaleY), width, height};
+			SDL_RenderSetScale(renderer, scaleX, scaleY);
+			SDL_RenderSetViewport(renderer, &scaled);
+			squeezing = true;
+		}
+		return;
+	} // Without the target there's no warp, but the renderer's own viewport and scale still squeeze the scene into its part of the screen. SDL scales the viewport too, so it's given unscaled.
+
+	if (warpTarget == nullptr) {
+		warpTarget = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+		if (warpTarget == nullptr) {
+			std::cout << "Failed to create the aberration target. Error: " << SDL_GetError() << std::endl;
+			warpFailed = true;
+			beginAberration(beta);
+			return;
+		}
+		SDL_SetTextureBlendMode(warpTarget, SDL_BLENDMODE_BLEND);
+	}
+
+	aberration.build(beta);
+	SDL_SetRenderTarget(renderer, warpTarget);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0xFF);
+	warping = true;
+} // The target is cleared to transparent, so whatever was on the screen before this shows around the edges that the warp pulls in.
+
+void RenderWindow::endAberration()
+{
+	if (squeezing) {
+		squeezing = false;
+		SDL_RenderSetScale(renderer, 1, 1);
+		SDL_RenderSetViewport(renderer, nullptr);
+		return;
+	}
+	if (!warping)
+		return;
+	warping = false;
+	SDL_SetRenderTarget(renderer, nullptr);
+
+	const std::vector<SDL_Vertex>* v = &aberration.vertices();
+	const std::vector<int>& t = aberration.indices();
+	if (viewportSet) {
+		placed = *v;
+		for (SDL_Vertex& p : placed) {
+			p.position.x = viewport.x + p.position.x * viewport.w / width;
+			p.position.y = viewport.y + p.position.y * viewport.h / height;
+		}
+		v = &placed;
+	}
+
+	if (SDL_RenderGeometry(renderer, warpTarget, v->data(), v->size(), t.data(), t.size()) < 0) {
+		std::cout << "Failed to draw the aberration mesh. Error: " << SDL_GetError() << std::endl;
+		SDL_RenderCopy(renderer, warpTarget, nullptr, viewportSet ? &viewport : nullptr);
+		warpFailed = true;
+	} // Drawn unwarped instead, so this frame still shows up.
+}
+
+void RenderWindow::setAberrationQuality(int columns)
+{
+	aberration.setColumns(columns);
+}
+
+void RenderWindow::setViewport(const SDL_Rect* area)
+{
+	endAberration();
+	viewportSet = (area != nullptr);
+	viewport = viewportSet ? *area : SDL_Rect{0, 0, width, height};
 }
 
 void RenderWindow::display()
 {
+	endAberration();
 	SDL_RenderPresent(renderer);
 }
 
@@ -0,0 +1,224 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "JobSystem.hpp"
+#include "SpatialGrid.hpp"
+
+SpatialGrid::SpatialGrid(int cellSize)
+: cellSize(cellSize), queryCount(0)
+{
+}
+
+static int floorDiv(int a, int b)
+{
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+} // Level coordinates go negative, and plain integer division would put -1 and 1 in the same cell.
+
+static long long cellKey(int x, int y)
+{
+	return (static_cast<long long>(x) << 32) ^ static_cast<unsigned int>(y);
+}
+
+SpatialGrid::Cells SpatialGrid::cellsUnder(SDL_Rect r) const
+{
+	return {floorDiv(r.x, cellSize), floorDiv(r.y, cellSize), floorDiv(r.x + r.w, cellSize), floorDiv(r.y + r.h, cellSize)};
+}
+
+void SpatialGrid::insert(int index, Cells c)
+{
+	for (int x = c.x1; x <= c.x2; x++) {
+		for (int y = c.y1; y <= c.y2; y++)
+			cells[cellKey(x, y)].push_back(index);
+	}
+}
+
+void SpatialGrid::erase(int index, Cells c)
+{
+	for (int x = c.x1; x <= c.x2; x++) {
+		for (int y = c.y1; y <= c.y2; y++) {
+			auto cell = cells.find(cellKey(x, y));
+			if (cell == cells.end())
+				continue;
+			vector<int>& list = cell->second;
+			for (unsigned int i = 0; i < list.size(); i++) {
+				if (list[i] == index) {
+					list[i] = list.back();
+					list.pop_back();
+					break;
+				}
+			}
+		}
+	}
+} // Empty cells are kept rather than freed, since moving platforms keep passing back through the same ones.
+
+void SpatialGrid::sync(int index, SDL_Rect r, bool collidable)
+{
+	if (index >= static_cast<int>(entries.size())) {
+		entries.resize(index+1, {{1, 0, 0, 0}, false, 0, 0, -1});
+		lastQuery.resize(index+1, 0);
+	}
+
+	Entry& entry = entries[index];
+	Cells now = cellsUnder(r);
+	entry.collidable = collidable;
+	if (now.x1 == entry.cells.x1 && now.y1 == entry.cells.y1 && now.x2 == entry.cells.x2 && now.y2 == entry.cells.y2)
+		return; // Moving entries that stay within their cells cost nothing beyond this comparison.
+
+	erase(index, entry.cells);
+	insert(index, now);
+	entry.cells = now;
+} // Entries are keyed by queue index, so when removeEntity() shifts the queue down, the next sync sees the new occupant of each index and re-bins it.
+
+bool SpatialGrid::unchanged(int index, const Entity& e)
+{
+	if (index >= static_cast<int>(entries.size())) {
+		entries.resize(index+1, {{1, 0, 0, 0}, false, 0, 0, -1});
+		lastQuery.resize(index+1, 0);
+	}
+
+	Entry& entry = entries[index];
+	float x = e.getX(), y = e.getY(), size = e.getSize();
+	if (x == entry.x && y == entry.y && size == entry.size)
+		return true;
+
+	entry.x = x;
+	entry.y = y;
+	entry.size = size;
+	return false;
+} // Static entries are only looked at this far, which keeps a sync over a large level to a few reads per entry.
+
+static SDL_Rect gridRect(const Entity& e)
+{
+	float y = e.isVanished() ? e.getY() - 9999 : e.getY();
+	return {static_cast<int>(e.getX()), static_cast<int>(y), static_cast<int>(e.getWidth() * e.getSize()), static_cast<int>(e.getHeight() * e.getSize())};
+} // Vanished entries keep the cells they'll reappear in, so the flames and lightning that blink on and off never need re-binning.
+
+void SpatialGrid::sync(const vector<Surface>* queue)
+{
+	for (unsigned int i = 0; i < queue->size(); i++) {
+		const Surface& s = queue->at(i);
+		if (unchanged(i, s))
+			continue;
+		sync(i, gridRect(s), !s.isVanished() && (s.getDamage() > 0 || s.isTrigger() || s.isSolid(1) || s.isSolid(2) || s.isSolid(3) || s.isSolid(4)));
+	}
+	trim(queue->size());
+}
+
+void SpatialGrid::sync(const vector<Body>* queue, const vector<bool>* hitboxQueue)
+{
+	for (unsigned int i = 0; i < queue->size(); i++) {
+		const Body& b = queue->at(i);
+		if (unchanged(i, b) && entries[i].collidable == (!b.isVanished() && hitboxQueue->at(i)))
+			continue;
+		sync(i, gridRect(b), !b.isVanished() && hitboxQueue->at(i));
+	}
+	trim(queue->size());
+} // The uncontracted rect is used, since length contraction and the platform epsilon in collided() only ever shrink it.
+
+void SpatialGrid::trim(int count)
+{
+	for (int i = count; i < static_cast<int>(entries.size()); i++)
+		erase(i, entries[i].cells);
+	if (count < static_cast<int>(entries.size())) {
+		entries.resize(count);
+		lastQuery.resize(count);
+	}
+}
+
+void SpatialGrid::clear()
+{
+	cells.clear();
+	entries.clear();
+	lastQuery.clear();
+}
+
+const vector<int>& SpatialGrid::query(SDL_Rect r)
+{
+	results.clear();
+	queryCount++;
+
+	Cells c = cellsUnder(r);
+	for (int x = c.x1; x <= c.x2; x++) {
+		for (int y = c.y1; y <= c.y2; y++) {
+			auto cell = cells.find(cellKey(x, y));
+			if (cell == cells.end())
+				continue;
+			for (int index : cell->second) {
+				if (entries[index].collidable && lastQuery[index] != queryCount) {
+					lastQuery[index] = queryCount;
+					results.push_back(index);
+				}
+			}
+		}
+	}
+
+	std::sort(results.begin(), results.end());
+	return results;
+} // The returned vector is reused by the next query.
+
+void SpatialGrid::candidates(SDL_Rect r, vector<int>* found) const
+{
+	Cells c = cellsUnder(r);
+	for (int x = c.x1; x <= c.x2; x++) {
+		for (int y = c.y1; y <= c.y2; y++) {
+			auto cell = cells.find(cellKey(x, y));
+			if (cell == cells.end())
+				continue;
+			for (int index : cell->second) {
+				if (entries[index].collidable)
+					found->push_back(index);
+			}
+		}
+	}
+
+	std::sort(found->begin(), found->end());
+	found->erase(std::unique(found->begin(), found->end()), found->end());
+} // Sorting out the duplicates costs more than the lastQuery stamps, but leaves the grid untouched.
+
+void SpatialGrid::pairs(const vector<SDL_Rect>& rects, vector<pair<int,int>>* out, JobSystem* jobs) const
+{
+	out->clear();
+	int count = rects.size();
+	if (jobs == nullptr || count < 2*PAIR_GRAIN) {
+		vector<int> found;
+		for (int i = 0; i < count; i++) {
+			found.clear();
+			candidates(rects[i], &found);
+			for (int index : found)
+				out->push_back({i, index});
+		}
+		return;
+	}
+
+	vector<vector<pair<int,int>>> chunkPairs(JobSystem::chunkCount(count, PAIR_GRAIN));
+	jobs->parallelFor(count, PAIR_GRAIN, [&](int begin, int end, int chunk) {
+		vector<int> found;
+		for (int i = begin; i < end; i++) {
+			found.clear();
+			candidates(rects[i], &found);
+			for (int index : found)
+				chunkPairs[chunk].push_back({i, index});
+		}
+	});
+
+	for (const vector<pair<int,int>>& p : chunkPairs)
+		out->insert(out->end(), p.begin(), p.end());
+} // Each chunk collects its own pairs, and they're joined in chunk order, so the output doesn't depend on which thread finished first.
+
+int SpatialGrid::size() const
+{
+	return entries.size();
+}
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <iostream>
+#include <vector>
 
 #include "Entity.hpp"
+#include "Fixed.hpp"
 #include "Body.hpp"
+#include "Path.hpp"
 #include "Surface.hpp"
 
 Surface::Surface(Entity e, bool rSolid, bool tSolid, bool lSolid, bool bSolid, int dmg, float s, bool h)
@@ -16,16 +19,18 @@ Surface::Surface(Entity e, bool rSolid, bool tSolid, bool lSolid, bool bSolid, i
 	solid[4] = bSolid; // true means that the surface's bottom side is solid.
 
 	damage = dmg;
+	trigger = false;
+	pathTime = 0;
 }
 
-bool Surface::isSolid(int i)
+bool Surface::isSolid(int i) const
 {
 	return solid[i];
 }
 
 
 
-int Surface::getDamage()
+int Surface::getDamage() const
 {
 	return damage;
 }
@@ -34,3 +39,38 @@ void Surface::setDamage(int d)
 {
 	damage = d;
 }
+
+void Surface::setTrigger()
+{
+	trigger = true;
+}
+
+bool Surface::isTrigger() const
+{
+	return trigger;
+}
+
+void Surface::setPath(const Path& p)
+{
+	path = p;
+	pathTime = 0;
+	followPath(0);
+}
+
+bool Surface::followsPath() const
+{
+	return !path.isEmpty();
+}
+
+void Surface::followPath(float dt)
+{
+	if (path.isEmpty())
+		return;
+
+	pathTime += dt;
+	std::pair<float,float> position = path.positionAt(pathTime), velocity = path.velocityAt(pathTime);
+	float y = isVanished() ? position.second + 9999 : position.second;
+	setCoords(position.first, y);
+	setXPrime(velocity.first);
+	setYPrime(velocity.second);
+}
\ No newline at end of file
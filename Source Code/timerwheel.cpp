@@ -0,0 +1,175 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include "Entity.hpp"
+#include "Fixed.hpp"
+#include "Body.hpp"
+#include "Path.hpp"
+#include "Surface.hpp"
+#include "GameFuncs.hpp"
+#include "TimerWheel.hpp"
+
+TimerWheel::TimerWheel()
+: freeList(-1), readFrom(0), ticks(0), count(0)
+{
+	std::fill(heads, heads + LEVELS*SLOTS, -1);
+}
+
+TimerId TimerWheel::start(int kind, int delay, int period, int target)
+{
+	int n = freeList;
+	if (n >= 0) {
+		freeList = nodes[n].next;
+	} else {
+		n = nodes.size();
+		nodes.push_back({0, 0, 0, 0, -1, -1, FREE, 0});
+	}
+
+	Node& node = nodes[n];
+	node.expires = ticks + std::max(delay, 1);
+	node.period = std::max(period, 0);
+	node.kind = kind;
+	node.target = target;
+	insert(n);
+	count++;
+	return {n, node.generation};
+}
+
+void TimerWheel::insert(int n)
+{
+	Node& node = nodes[n];
+	long long delta = static_cast<long long>(node.expires) - ticks;
+	int level = 0;
+	while (level < LEVELS-1 && delta >= (1LL << (SLOT_BITS*(level+1))))
+		level++;
+
+	int slot = (node.expires >> (SLOT_BITS*level)) & MASK;
+	if (delta >= (1LL << (SLOT_BITS*LEVELS)))
+		slot = ((ticks >> (SLOT_BITS*level)) - 1) & MASK; // The last top-level slot to come round, which is as far off as the wheel reaches.
+
+	node.list = level*SLOTS + slot;
+	node.prev = -1;
+	node.next = heads[node.list];
+	if (node.next >= 0)
+		nodes[node.next].prev = n;
+	heads[node.list] = n;
+}
+
+void TimerWheel::unlink(int n)
+{
+	Node& node = nodes[n];
+	if (node.list < 0)
+		return;
+	if (node.prev >= 0)
+		nodes[node.prev].next = node.next;
+	else
+		heads[node.list] = node.next;
+	if (node.next >= 0)
+		nodes[node.next].prev = node.prev;
+	node.list = READY;
+}
+
+void TimerWheel::release(int n)
+{
+	unlink(n);
+	nodes[n].list = FREE;
+	nodes[n].generation++;
+	nodes[n].next = freeList;
+	freeList = n;
+	count--;
+}
+
+void TimerWheel::cancel(TimerId& id)
+{
+	if (pending(id))
+		release(id.node);
+	id = TimerId();
+} // Any ready entries it left behind no longer match its generation, so pop() skips them.
+
+bool TimerWheel::pending(TimerId id) const
+{
+	return id.node >= 0 && id.node < static_cast<int>(nodes.size()) && nodes[id.node].generation == id.generation && nodes[id.node].list != FREE;
+}
+
+void TimerWheel::cascade(int level)
+{
+	int list = level*SLOTS + ((ticks >> (SLOT_BITS*level)) & MASK);
+	int n = heads[list];
+	heads[list] = -1;
+	while (n >= 0) {
+		int next = nodes[n].next;
+		insert(n);
+		n = next;
+	}
+} // Hands the slot that's just come round down to the levels below, now that its timers are within their reach.
+
+void TimerWheel::advance()
+{
+	ticks++;
+	for (int level = 1; level < LEVELS && (ticks & ((1 << (SLOT_BITS*level)) - 1)) == 0; level++)
+		cascade(level);
+
+	int n = heads[ticks & MASK];
+	heads[ticks & MASK] = -1;
+	while (n >= 0) {
+		Node& node = nodes[n];
+		int next = node.next;
+		ready.push_back({n, node.generation});
+		node.list = READY;
+		if (node.period > 0) {
+			node.expires += node.period;
+			insert(n);
+		}
+		n = next;
+	} // Everything in the current level 0 slot expires on this tick.
+}
+
+bool TimerWheel::pop(Fired* fired)
+{
+	while (readFrom < ready.size()) {
+		TimerId id = ready[readFrom++];
+		if (!pending(id))
+			continue;
+
+		*fired = {nodes[id.node].kind, nodes[id.node].target, id};
+		if (nodes[id.node].period == 0)
+			release(id.node);
+		return true;
+	}
+
+	ready.clear();
+	readFrom = 0;
+	return false;
+}
+
+void TimerWheel::clear()
+{
+	for (unsigned int i = 0; i < nodes.size(); i++) {
+		if (nodes[i].list != FREE)
+			release(i);
+	}
+	ready.clear();
+	readFrom = 0;
+}
+
+int TimerWheel::now() const
+{
+	return ticks;
+}
+
+int TimerWheel::size() const
+{
+	return count;
+}
+
+int TimerWheel::until(int now, int period, int phase)
+{
+	int d = ((phase - now) % period + period) % period;
+	return (d == 0) ? period : d;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include "VoiceManager.hpp"
+
+VoiceManager* VoiceManager::current = nullptr;
+
+VoiceManager::VoiceManager(int channels)
+: busy(0), head(0), tail(0), halting(-2)
+{
+	channels = Mix_AllocateChannels(channels);
+	voices.assign(std::max(channels, 0), {-1, 0});
+	current = this;
+	Mix_ChannelFinished(finished);
+}
+
+VoiceManager::~VoiceManager()
+{
+	if (current == this)
+		detach();
+} // Does nothing if detach() has been called, since by now the mixer may be gone.
+
+void VoiceManager::detach()
+{
+	Mix_ChannelFinished(nullptr);
+	current = nullptr;
+}
+
+void VoiceManager::define(const std::string& key, Mix_Chunk* chunk, Priority priority, int maxInstances, Uint32 cooldown)
+{
+	auto found = keys.find(key);
+	if (found != keys.end()) {
+		Sound& s = sounds[found->second];
+		s.chunk = chunk;
+		s.priority = priority;
+		s.maxInstances = std::max(maxInstances, 1);
+		s.cooldown = cooldown;
+		return;
+	} // Redefining a sound keeps count of the instances of it already playing.
+	keys[key] = sounds.size();
+	sounds.push_back({key, chunk, priority, std::max(maxInstances, 1), 0, cooldown, 0, false});
+}
+
+int VoiceManager::play(const std::string& key, int loops)
+{
+	auto found = keys.find(key);
+	if (found == keys.end()) {
+		std::cout << "Failed to play " << key << ". Error: it was never defined." << std::endl;
+		return -1;
+	}
+	int index = found->second;
+	Sound& s = sounds[index];
+
+	Uint32 now = SDL_GetTicks();
+	if (s.started && now - s.lastStart < s.cooldown) {
+		counts.cooling++;
+		return -1;
+	}
+	if (s.playing >= s.maxInstances) {
+		counts.limited++;
+		return -1;
+	}
+
+	int channel = freeChannel();
+	if (channel < 0) {
+		update();
+		channel = freeChannel();
+	} // A channel may have finished since the last update().
+	if (channel < 0) {
+		for (unsigned int i = 0; i < voices.size(); i++) {
+			Priority p = sounds[voices[i].sound].priority;
+			if (p >= s.priority)
+				continue;
+			if (channel < 0 || p < sounds[voices[channel].sound].priority || (p == sounds[voices[channel].sound].priority && voices[i].start < voices[channel].start))
+				channel = i;
+		}
+		if (channel < 0) {
+			counts.dropped++;
+			return -1;
+		}
+		halting = channel;
+		Mix_HaltChannel(channel);
+		halting = -2;
+		release(channel);
+		counts.stolen++;
+	} // Halting calls finished() on this thread, which would make it a second producer for the queue, so it's told to ignore this channel.
+
+	halting = channel;
+	int played = Mix_PlayChannel(channel, s.chunk, loops);
+	halting = -2;
+	if (played < 0) {
+		std::cout << "Failed to play " << key << ". Error: " << Mix_GetError() << std::endl;
+		return -1;
+	}
+
+	voices[channel] = {index, now};
+	s.playing++;
+	s.lastStart = now;
+	s.started = true;
+	busy++;
+	counts.played++;
+	counts.peak = std::max(counts.peak, busy);
+	return channel;
+}
+
+void VoiceManager::stopAll()
+{
+	halting = -1;
+	Mix_HaltChannel(-1);
+	halting = -2;
+	for (unsigned int i = 0; i < voices.size(); i++) {
+		if (voices[i].sound >= 0)
+			release(i);
+	}
+}
+
+void VoiceManager::finished(int channel)
+{
+	VoiceManager* self = current;
+	if (self == nullptr)
+		return;
+	int h = self->halting;
+	if (h == -1 || h == channel)
+		return; // Freed by the thread halting it.
+
+	unsigned int t = self->tail.load(std::memory_order_relaxed);
+	if (t - self->head.load(std::memory_order_acquire) >= QUEUE)
+		return; // Full. update() checks every channel when it finds it that way.
+	self->done[t % QUEUE] = channel;
+	self->tail.store(t + 1, std::memory_order_release);
+} // Runs on the audio thread with the mixer locked, so it only writes down the channel.
+
+void VoiceManager::update()
+{
+	unsigned int h = head.load(std::memory_order_relaxed), t = tail.load(std::memory_order_acquire);
+	bool full = (t - h >= QUEUE);
+	for (; h != t; h++) {
+		int channel = done[h % QUEUE];
+		if (channel >= 0 && channel < static_cast<int>(voices.size()) && voices[channel].sound >= 0 && !Mix_Playing(channel))
+			release(channel);
+	} // A channel that was stolen after it finished, but before this saw it, is playing again, so it's left alone.
+	head.store(h, std::memory_order_release);
+
+	if (full) {
+		for (unsigned int i = 0; i < voices.size(); i++) {
+			if (voices[i].sound >= 0 && !Mix_Playing(i))
+				release(i);
+		}
+	} // Some finishes may have been turned away.
+}
+
+int VoiceManager::freeChannel() const
+{
+	for (unsigned int i = 0; i < voices.size(); i++) {
+		if (voices[i].sound < 0)
+			return i;
+	}
+	return -1;
+}
+
+void VoiceManager::release(int channel)
+{
+	sounds[voices[channel].sound].playing--;
+	voices[channel].sound = -1;
+	busy--;
+}
+
+int VoiceManager::inUse() const
+{
+	return busy;
+}
+
+int VoiceManager::channels() const
+{
+	return voices.size();
+}
+
+const VoiceManager::Stats& VoiceManager::stats() const
+{
+	return counts;
+}
+
+void VoiceManager::report() const
+{
+	std::cout << "Voices: " << counts.played << " sounds played on " << voices.size() << " channels, at most " << counts.peak << " at once\n";
+	std::cout << "  " << counts.stolen << " cut off for more important sounds\n";
+	std::cout << "  " << counts.dropped << " dropped with every channel busy, " << counts.limited << " over their instance limit, " << counts.cooling << " within their cooldown\n";
+}
\ No newline at end of file